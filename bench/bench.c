@@ -0,0 +1,668 @@
+// https://github.com/auribuo/ccli
+//
+// Copyright (c) 2024 Aurelio Buonomo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file bench.c
+ * @brief Micro benchmarks of the ccli parser
+ *
+ * Build and run from the root of the repository:
+ *
+ *     cc -O2 -o bench/bench bench/bench.c
+ *     ./bench/bench > bench_output.txt
+ *
+ * Every line of the output is a CSV record. See @ref print_header for the columns.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC 1
+#else
+#define BENCH_HAS_TSC 0
+#endif
+
+#define CCLI_IMPLEMENTATION
+#include "../cli.h"
+
+static uint64_t allocations = 0;
+
+/**
+ * @brief Allocator hooks counting every allocation of the library in the counter passed as context.
+ */
+static void *count_malloc(void *ctx, size_t size) {
+    (*(uint64_t *)ctx)++;
+    return malloc(size);
+}
+
+static void *count_realloc(void *ctx, void *ptr, size_t size) {
+    (*(uint64_t *)ctx)++;
+    return realloc(ptr, size);
+}
+
+static void count_free(void *ctx, void *ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+/**
+ * @brief Kinds of argv vectors generated for a table.
+ */
+typedef enum {
+    kind_short,      /**< Boolean flags in short form (-x) */
+    kind_cluster,    /**< Boolean flags in short form clustered by eight (-abcdefgh) */
+    kind_long,       /**< Boolean flags in long form (--opt-n) */
+    kind_equals,     /**< String options in the form --opt-n=value */
+    kind_numeric,    /**< Number options followed by decimal and hexadecimal values */
+    kind_positional, /**< Positional arguments */
+    kind_count,
+} argv_kind;
+
+static const char *kind_names[kind_count] = {"short", "cluster", "long", "equals", "numeric", "positional"};
+
+/**
+ * @brief Synthetic cli tables.
+ */
+typedef struct {
+    size_t opt_count;      /**< The amount of options excluding the terminator */
+    size_t cmd_count;      /**< The amount of commands excluding the terminator */
+    cli_command *commands; /**< The zero-terminated commands */
+    cli_option *options;   /**< The zero-terminated options */
+    cli_data *data;        /**< Storage of the options */
+    char **names;          /**< Storage of the names of the commands and options */
+} bench_table;
+
+/**
+ * @brief A generated argv vector.
+ */
+typedef struct {
+    int argc;    /**< The length of argv */
+    char **argv; /**< The argv vector */
+} bench_argv;
+
+static const char short_args[] = "abcdefgijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+#define POSITIONALS 8
+
+/**
+ * @brief Returns the type of the i-th generated option.
+ */
+static cli_option_type table_type(size_t i) {
+    switch (i % 4) {
+    case 0:
+    case 2:
+        return boolean;
+    case 1:
+        return string;
+    default:
+        return number;
+    }
+}
+
+/**
+ * @brief Returns the command value of the i-th generated option as encoded in @ref CLI_ARG_MAKE.
+ *
+ * Every eighth option is global, the rest is spread across the commands.
+ */
+static size_t table_cmd(size_t i, size_t cmd_count) {
+    if (i % 8 == 0) {
+        return 0;
+    }
+    return (i % cmd_count) + 2;
+}
+
+/**
+ * @brief Generates a table with opt_count options spread across cmd_count commands. The last command additionally owns @ref POSITIONALS positional options.
+ */
+static bench_table table_make(size_t opt_count, size_t cmd_count) {
+    bench_table table;
+    table.opt_count = opt_count + POSITIONALS;
+    table.cmd_count = cmd_count;
+    table.commands = calloc(cmd_count + 1, sizeof(cli_command));
+    table.options = calloc(table.opt_count + 1, sizeof(cli_option));
+    table.data = calloc(table.opt_count, sizeof(cli_data));
+    table.names = calloc(cmd_count + table.opt_count, sizeof(char *));
+
+    for (size_t i = 0; i < cmd_count; i++) {
+        table.names[i] = malloc(24);
+        snprintf(table.names[i], 24, "cmd-%zu", i);
+        table.commands[i].command = table.names[i];
+        table.commands[i].desc = "Generated command";
+    }
+
+    size_t short_idx = 0;
+    for (size_t i = 0; i < table.opt_count; i++) {
+        char *name = table.names[cmd_count + i] = malloc(24);
+        cli_option *opt = &table.options[i];
+        opt->long_arg = name;
+        opt->data = &table.data[i];
+        opt->desc = "Generated option";
+        if (i >= opt_count) {
+            snprintf(name, 24, "pos-%zu", i - opt_count);
+            opt->params = CLI_ARG_MAKE(string, 0, 1, (cmd_count + 1));
+            continue;
+        }
+        snprintf(name, 24, "opt-%zu", i);
+        cli_option_type type = table_type(i);
+        size_t cmd = table_cmd(i, cmd_count);
+        opt->params = CLI_ARG_MAKE(type, 0, 0, cmd);
+        opt->arg_desc = type == boolean ? NULL : "VALUE";
+        if (type == boolean && (cmd == 0 || cmd == cmd_count + 1) && short_idx < sizeof(short_args) - 1) {
+            opt->short_arg = short_args[short_idx++];
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief Releases a table created with @ref table_make.
+ */
+static void table_free(bench_table *table) {
+    for (size_t i = 0; i < table->cmd_count + table->opt_count; i++) {
+        free(table->names[i]);
+    }
+    free(table->names);
+    free(table->data);
+    free(table->options);
+    free(table->commands);
+}
+
+/**
+ * @brief Appends a copy of the given string to the argv vector.
+ */
+static void argv_push(bench_argv *args, size_t cap, const char *arg) {
+    if ((size_t)args->argc >= cap) {
+        return;
+    }
+    size_t len = strlen(arg) + 1;
+    args->argv[args->argc] = malloc(len);
+    memcpy(args->argv[args->argc++], arg, len);
+}
+
+/**
+ * @brief Generates an argv vector of the given kind invoking the last command of the table with at most tokens arguments after the command.
+ */
+static bench_argv argv_make(const bench_table *table, argv_kind kind, size_t tokens) {
+    bench_argv args = {0};
+    size_t cap = tokens + 2;
+    args.argv = calloc(cap + 1, sizeof(char *));
+    argv_push(&args, cap, "bench");
+    argv_push(&args, cap, table->commands[table->cmd_count - 1].command);
+
+    size_t cmd = table->cmd_count + 1;
+    char buf[64];
+    size_t produced = 0;
+    if (kind == kind_cluster) {
+        char flags[sizeof(short_args)];
+        size_t flag_count = 0;
+        for (size_t i = 0; i < table->opt_count && flag_count < sizeof(short_args) - 1; i++) {
+            cli_option opt = table->options[i];
+            if ((CLI_ARG_GLOBAL(opt.params) || CLI_ARG_CMD(opt.params) == cmd) && opt.short_arg != 0 && CLI_ARG_TYPE(opt.params) == boolean && memchr(flags, opt.short_arg, flag_count) == NULL) {
+                flags[flag_count++] = opt.short_arg;
+            }
+        }
+        for (size_t flag = 0; flag_count > 0 && produced < tokens; produced++) {
+            buf[0] = '-';
+            for (size_t i = 1; i <= 8; i++) {
+                buf[i] = flags[flag++ % flag_count];
+            }
+            buf[9] = 0;
+            argv_push(&args, cap, buf);
+        }
+        return args;
+    }
+    for (size_t round = 0; round < tokens && produced < tokens; round++) {
+        size_t before = produced;
+        for (size_t i = 0; i < table->opt_count && produced < tokens; i++) {
+            cli_option opt = table->options[i];
+            if (!(CLI_ARG_GLOBAL(opt.params)) && CLI_ARG_CMD(opt.params) != cmd) {
+                continue;
+            }
+            bool positional = CLI_ARG_POSITIONAL(opt.params);
+            switch (kind) {
+            case kind_short:
+                if (positional || opt.short_arg == 0) {
+                    continue;
+                }
+                snprintf(buf, sizeof(buf), "-%c", opt.short_arg);
+                argv_push(&args, cap, buf);
+                produced++;
+                break;
+            case kind_long:
+                if (positional || CLI_ARG_TYPE(opt.params) != boolean) {
+                    continue;
+                }
+                snprintf(buf, sizeof(buf), "--%s", opt.long_arg);
+                argv_push(&args, cap, buf);
+                produced++;
+                break;
+            case kind_equals:
+                if (positional || CLI_ARG_TYPE(opt.params) != string) {
+                    continue;
+                }
+                snprintf(buf, sizeof(buf), "--%s=value-%zu", opt.long_arg, i);
+                argv_push(&args, cap, buf);
+                produced++;
+                break;
+            case kind_numeric:
+                if (positional || CLI_ARG_TYPE(opt.params) != number) {
+                    continue;
+                }
+                snprintf(buf, sizeof(buf), "--%s", opt.long_arg);
+                argv_push(&args, cap, buf);
+                if (i % 2 == 0) {
+                    snprintf(buf, sizeof(buf), "%llu", 1234567890123ULL + i);
+                } else {
+                    snprintf(buf, sizeof(buf), "0x%llx", 0xdeadbeefULL + i);
+                }
+                argv_push(&args, cap, buf);
+                produced += 2;
+                break;
+            case kind_positional:
+                if (!positional || produced >= POSITIONALS) {
+                    continue;
+                }
+                snprintf(buf, sizeof(buf), "file-%zu.txt", produced);
+                argv_push(&args, cap, buf);
+                produced++;
+                break;
+            default:
+                break;
+            }
+        }
+        if (produced == before) {
+            break;
+        }
+    }
+    return args;
+}
+
+/**
+ * @brief Releases an argv vector created with @ref argv_make.
+ */
+static void argv_free(bench_argv *args) {
+    for (int i = 0; i < args->argc; i++) {
+        free(args->argv[i]);
+    }
+    free(args->argv);
+}
+
+/**
+ * @brief Returns the current monotonic time in nanoseconds.
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Returns the current value of the time stamp counter or 0 if there is none.
+ */
+static uint64_t now_cycles(void) {
+#if BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Measurements of a single benchmark.
+ */
+typedef struct {
+    uint64_t runs;   /**< The amount of measured runs */
+    uint64_t ns;     /**< Total wall time */
+    uint64_t cycles; /**< Total cycles */
+    uint64_t allocs; /**< Total allocations */
+} bench_sample;
+
+/**
+ * @brief Prints the CSV header.
+ */
+static void print_header(void) {
+    printf("bench,kind,options,commands,argc,runs,ns_per_parse,allocs_per_parse,cycles_per_token\n");
+}
+
+/**
+ * @brief Prints a CSV record for the given sample.
+ */
+static void print_sample(const char *bench, const char *kind, size_t options, size_t commands, int tokens, bench_sample sample) {
+    double runs = (double)sample.runs;
+    double cycles = BENCH_HAS_TSC && tokens > 0 ? (double)sample.cycles / runs / tokens : -1;
+    printf("%s,%s,%zu,%zu,%d,%llu,%.1f,%.2f,%.2f\n", bench, kind, options, commands, tokens, (unsigned long long)sample.runs,
+           (double)sample.ns / runs, (double)sample.allocs / runs, cycles);
+    fflush(stdout);
+}
+
+static uint64_t target_ns = 100000000;
+
+/**
+ * @brief Fails the benchmark if a parse of flags allocated, which the parser guarantees not to do.
+ */
+static void check_no_allocs(const char *bench, argv_kind kind, size_t opt_count, bench_sample sample) {
+    bool flags = kind == kind_short || kind == kind_cluster || kind == kind_long;
+    if (flags && sample.allocs != 0) {
+        fprintf(stderr, "bench: %s parse of %s flags over %zu options allocated %llu times in %llu runs\n", bench, kind_names[kind], opt_count,
+                (unsigned long long)sample.allocs, (unsigned long long)sample.runs);
+        exit(1);
+    }
+}
+
+/**
+ * @brief Parses the argv vector with a precompiled parser until the time budget is used up.
+ */
+static bench_sample bench_compiled(const cli_parser *parser, bench_argv *args, cli_arena *arena) {
+    cli_data *values = calloc(parser->opt_count, sizeof(cli_data));
+    bool *matched = calloc(parser->opt_count, sizeof(bool));
+    bench_sample sample = {0};
+    cli_result result = {.values = values, .matched = matched, .arena = arena};
+
+    if (cli_parser_try_parse(parser, args->argc, args->argv, &result) != cli_ok) {
+        fprintf(stderr, "bench: generated argv does not parse: %s\n", result.error.message);
+        exit(1);
+    }
+
+    uint64_t batch = 16;
+    while (sample.ns < target_ns) {
+        uint64_t allocs = allocations;
+        uint64_t cycles = now_cycles();
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < batch; i++) {
+            cli_parser_try_parse(parser, args->argc, args->argv, &result);
+            if (arena != NULL) {
+                cli_arena_reset(arena);
+            }
+        }
+        sample.ns += now_ns() - start;
+        sample.cycles += now_cycles() - cycles;
+        sample.allocs += allocations - allocs;
+        sample.runs += batch;
+        batch *= 2;
+    }
+
+    free(matched);
+    free(values);
+    return sample;
+}
+
+/**
+ * @brief Parses the argv vector with @ref cli_try_parse_opts, which sets the parser up on every call, until the time budget is used up.
+ */
+static bench_sample bench_oneshot(bench_table *table, bench_argv *args) {
+    bench_sample sample = {0};
+    cli_result result = {0};
+    uint64_t batch = 1;
+    while (sample.ns < target_ns) {
+        uint64_t allocs = allocations;
+        uint64_t cycles = now_cycles();
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < batch; i++) {
+            cli_try_parse_opts(table->commands, table->options, args->argc, args->argv, NULL, &result);
+        }
+        sample.ns += now_ns() - start;
+        sample.cycles += now_cycles() - cycles;
+        sample.allocs += allocations - allocs;
+        sample.runs += batch;
+        batch *= 2;
+    }
+    return sample;
+}
+
+/**
+ * @brief Measures the setup cost of a parser for the given table.
+ */
+static bench_sample bench_compile(bench_table *table) {
+    bench_sample sample = {0};
+    uint64_t batch = 1;
+    while (sample.ns < target_ns) {
+        uint64_t allocs = allocations;
+        uint64_t cycles = now_cycles();
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < batch; i++) {
+            cli_parser_free(cli_parser_compile(table->commands, table->options, NULL, NULL));
+        }
+        sample.ns += now_ns() - start;
+        sample.cycles += now_cycles() - cycles;
+        sample.allocs += allocations - allocs;
+        sample.runs += batch;
+        batch *= 2;
+    }
+    return sample;
+}
+
+/**
+ * @brief Measures the setup cost of a parser initialized over tables of known length into static storage.
+ */
+static bench_sample bench_static(bench_table *table) {
+    bench_sample sample = {0};
+    uint32_t *storage = malloc(sizeof(uint32_t) * CLI_INDEX_STORAGE(table->opt_count));
+    uint32_t *cmd_storage = malloc(sizeof(uint32_t) * CLI_COMMAND_INDEX_STORAGE(table->cmd_count));
+    uint64_t batch = 1;
+    while (sample.ns < target_ns) {
+        uint64_t allocs = allocations;
+        uint64_t cycles = now_cycles();
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < batch; i++) {
+            cli_parser parser;
+            cli_parser_init_static(&parser, table->commands, table->cmd_count, cmd_storage, table->options, table->opt_count, storage, NULL, NULL);
+        }
+        sample.ns += now_ns() - start;
+        sample.cycles += now_cycles() - cycles;
+        sample.allocs += allocations - allocs;
+        sample.runs += batch;
+        batch *= 2;
+    }
+    free(cmd_storage);
+    free(storage);
+    return sample;
+}
+
+/**
+ * @brief Measures rendering the help menu of the root command, either served from the cache of the parser or rendered from the tables every time.
+ */
+static bench_sample bench_help(bench_table *table, const cli_parser *parser) {
+    bench_sample sample = {0};
+    uint64_t batch = 1;
+    while (sample.ns < target_ns) {
+        uint64_t allocs = allocations;
+        uint64_t cycles = now_cycles();
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < batch; i++) {
+            char *help = parser != NULL ? cli_parser_help_render(parser, NULL, "bench", NULL) : cli_help_render(table->commands, NULL, table->options, "bench", NULL, NULL);
+            cli_free(help);
+        }
+        sample.ns += now_ns() - start;
+        sample.cycles += now_cycles() - cycles;
+        sample.allocs += allocations - allocs;
+        sample.runs += batch;
+        batch *= 2;
+    }
+    return sample;
+}
+
+/**
+ * @brief Reference implementation parsing like the strtol based cli_try_parse_int of v1.0.0 (decimal, then hexadecimal, then binary).
+ */
+static bool parse_int_strtol(char *num, int64_t *data) {
+    char *end;
+    long long parsed = strtoll(num, &end, 10);
+    if (end != num && *end == '\0') {
+        *data = parsed;
+        return true;
+    }
+    if (strlen(num) > 2 && num[0] == '0' && num[1] == 'x') {
+        parsed = strtoll(num, &end, 16);
+        if (end != num && *end == '\0') {
+            *data = parsed;
+            return true;
+        }
+    }
+    if (strlen(num) > 2 && num[0] == '0' && num[1] == 'b') {
+        parsed = strtoll(num + 2, &end, 2);
+        if (end != num + 2 && *end == '\0') {
+            *data = parsed;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Measures a number parser on the given input until the time budget is used up.
+ */
+static bench_sample bench_int(bool (*parse)(char *, int64_t *), char *input) {
+    bench_sample sample = {0};
+    volatile int64_t sink = 0;
+    uint64_t batch = 1024;
+    while (sample.ns < target_ns) {
+        uint64_t cycles = now_cycles();
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < batch; i++) {
+            int64_t value = 0;
+            parse(input, &value);
+            sink += value;
+        }
+        sample.ns += now_ns() - start;
+        sample.cycles += now_cycles() - cycles;
+        sample.runs += batch;
+        batch *= 2;
+    }
+    (void)sink;
+    return sample;
+}
+
+/**
+ * @brief Compares @ref cli_try_parse_int with the strtol based reference on typical inputs.
+ */
+static void bench_numbers(void) {
+    static char dec_short[] = "42";
+    static char dec_long[] = "1234567890123456789";
+    static char dec_negative[] = "-987654321";
+    static char hex[] = "0xdeadbeefcafe";
+    static char bin[] = "0b1011001110001111";
+    static struct {
+        const char *kind;
+        char *input;
+    } inputs[] = {
+        {"dec_short", dec_short},
+        {"dec_long", dec_long},
+        {"dec_negative", dec_negative},
+        {"hex", hex},
+        {"bin", bin},
+    };
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        print_sample("int_cli", inputs[i].kind, 0, 0, 1, bench_int(cli_try_parse_int, inputs[i].input));
+        print_sample("int_strtol", inputs[i].kind, 0, 0, 1, bench_int(parse_int_strtol, inputs[i].input));
+    }
+}
+
+static cli_data tokens_data = {.unum_data = 64};
+static cli_data time_data = {.unum_data = 100};
+static cli_data filter_data = {.str_data = NULL};
+static cli_data quick_data = {.bool_data = false};
+
+static cli_option bench_options[] = {
+    {'t', "tokens", CLI_ARG_MAKE_GLOBAL(unumber, 0, 0), &tokens_data, "Maximum amount of arguments per generated argv (default 64)", "count"},
+    {'m', "time", CLI_ARG_MAKE_GLOBAL(unumber, 0, 0), &time_data, "Time budget per benchmark in milliseconds (default 100)", "ms"},
+    {'f', "filter", CLI_ARG_MAKE_GLOBAL(string, 0, 0), &filter_data, "Only run benchmarks whose name contains the filter", "name"},
+    {'q', "quick", CLI_ARG_MAKE_GLOBAL(boolean, 0, 0), &quick_data, "Only run the smallest and the largest tables", NULL},
+    {0},
+};
+
+/**
+ * @brief Returns whether the benchmark with the given name should run.
+ */
+static bool selected(const char *name) {
+    return filter_data.str_data == NULL || strstr(name, filter_data.str_data) != NULL;
+}
+
+int main(int argc, char *argv[]) {
+    cli_allocator allocator = {count_malloc, count_realloc, count_free, &allocations};
+    cli_set_allocator(&allocator);
+    cli_parse_opts(NULL, bench_options, argc, argv, NULL, NULL);
+    target_ns = time_data.unum_data * 1000000ULL;
+
+    static const size_t option_counts[] = {10, 100, 1000, 10000};
+    static const size_t command_counts[] = {1, 16, 250, 10000};
+    size_t option_len = sizeof(option_counts) / sizeof(option_counts[0]);
+    size_t command_len = sizeof(command_counts) / sizeof(command_counts[0]);
+
+    print_header();
+    if (selected("int")) {
+        bench_numbers();
+    }
+    for (size_t o = 0; o < option_len; o++) {
+        for (size_t c = 0; c < command_len; c++) {
+            if (quick_data.bool_data && !((o == 0 && c == 0) || (o == option_len - 1 && c == command_len - 1))) {
+                continue;
+            }
+            size_t opt_count = option_counts[o];
+            size_t cmd_count = command_counts[c];
+            bench_table table = table_make(opt_count, cmd_count);
+
+            if (selected("compile")) {
+                print_sample("compile", "-", opt_count, cmd_count, 0, bench_compile(&table));
+            }
+            if (selected("static")) {
+                print_sample("static", "-", opt_count, cmd_count, 0, bench_static(&table));
+            }
+
+            cli_parser *parser = cli_parser_compile(table.commands, table.options, NULL, NULL);
+            if (selected("help")) {
+                print_sample("help", "cached", opt_count, cmd_count, 0, bench_help(&table, parser));
+                print_sample("help", "uncached", opt_count, cmd_count, 0, bench_help(&table, NULL));
+            }
+            for (argv_kind kind = 0; kind < kind_count; kind++) {
+                bench_argv args = argv_make(&table, kind, tokens_data.unum_data);
+                int tokens = args.argc - 2;
+                if (tokens > 0 && selected("parse")) {
+                    bench_sample sample = bench_compiled(parser, &args, NULL);
+                    check_no_allocs("compiled", kind, opt_count, sample);
+                    print_sample("parse", kind_names[kind], opt_count, cmd_count, tokens, sample);
+                }
+                if (tokens > 0 && selected("arena")) {
+                    cli_arena arena;
+                    cli_arena_init(&arena, 0);
+                    bench_sample sample = bench_compiled(parser, &args, &arena);
+                    check_no_allocs("arena", kind, opt_count, sample);
+                    print_sample("arena", kind_names[kind], opt_count, cmd_count, tokens, sample);
+                    cli_arena_free(&arena);
+                }
+                if (tokens > 0 && selected("oneshot")) {
+                    bench_sample sample = bench_oneshot(&table, &args);
+                    if (opt_count <= CLI_ONESHOT_INDEX_OPTIONS) {
+                        check_no_allocs("oneshot", kind, opt_count, sample);
+                    }
+                    print_sample("oneshot", kind_names[kind], opt_count, cmd_count, tokens, sample);
+                }
+                argv_free(&args);
+            }
+            cli_parser_free(parser);
+            table_free(&table);
+        }
+    }
+    return 0;
+}
@@ -36,6 +36,10 @@
 #include <string.h>
 #include <unistd.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @def CLI_ARG_NULL
  * @brief The NULL argument. Used for termination of the options array.
@@ -70,7 +74,7 @@
  * @def CLI_ARG_CMD_MASK
  * @brief Bitmask for the bits controlling the command of a option.
  */
-#define CLI_ARG_CMD_MASK 0b0001111111100000
+#define CLI_ARG_CMD_MASK 0xffffffff00000000
 
 /**
  * @def CLI_ARG_MAKE(typ, req, pos, cmd)
@@ -84,16 +88,16 @@
  *
  * The params field of an @ref option_t has the following structure:
  *
- * Binary representation: 0000000000000000
- * Legend:                rpmccccccccttttt
+ * Binary representation: 00000000000000000000000000000000 0000000000000000 0000000000000000
+ * Legend:                cccccccccccccccccccccccccccccccc 0000000000000000 rpm00000000ttttt
+ * c = command where 0 = global, 1 = root, n - 2 = index in commands
  * r = required
  * p = positional
  * m = matched
- * c = command where 0 = global, 1 = root, n - 2 = index in commands
  * t = type
  */
 #define CLI_ARG_MAKE(typ, req, pos, cmd) \
-    ((req << 15) | (pos << 14) | (cmd << 5) | typ) & (~CLI_ARG_MAT_MASK)
+    (((uint64_t)(cmd) << 32) | (req << 15) | (pos << 14) | typ) & (~CLI_ARG_MAT_MASK)
 
 /**
  * @def CLI_ARG_MAKE_GLOBAL(typ, req, pos)
@@ -135,28 +139,28 @@
  * @brief Evaluates to the cmd part of the given option.
  * @param arg The params field of the @ref option_t
  */
-#define CLI_ARG_CMD(arg) ((arg & CLI_ARG_CMD_MASK) >> 5)
+#define CLI_ARG_CMD(arg) ((arg & CLI_ARG_CMD_MASK) >> 32)
 
 /**
  * @def CLI_ARG_CMD_IDX(arg)
  * @brief Evaluates to the index in the command field of the given option. Using it on global or root options results in an invalid index.
  * @param arg The params field of the @ref option_t
  */
-#define CLI_ARG_CMD_IDX(arg) ((arg & CLI_ARG_CMD_MASK) >> 5) - 2
+#define CLI_ARG_CMD_IDX(arg) ((arg & CLI_ARG_CMD_MASK) >> 32) - 2
 
 /**
  * @def CLI_ARG_GLOBAL(arg)
  * @brief Evaluates whether the option is global or not.
  * @param arg The params field of the @ref option_t
  */
-#define CLI_ARG_GLOBAL(arg) ((arg & CLI_ARG_CMD_MASK) >> 5) == 0
+#define CLI_ARG_GLOBAL(arg) ((arg & CLI_ARG_CMD_MASK) >> 32) == 0
 
 /**
  * @def CLI_ARG_ROOT(arg)
  * @brief Evaluates whether the option is a root flag or not.
  * @param arg The params field of the @ref option_t
  */
-#define CLI_ARG_ROOT(arg) ((arg & CLI_ARG_CMD_MASK) >> 5) == 1
+#define CLI_ARG_ROOT(arg) ((arg & CLI_ARG_CMD_MASK) >> 32) == 1
 
 /**
  * @def CLI_ARG_REQUIRED(arg)
@@ -186,6 +190,15 @@
  */
 #define CLI_ARG_SET_MATCHED(arg) (arg | CLI_ARG_MAT_MASK)
 
+/**
+ * @brief Growable array holding the values of a list option.
+ */
+typedef struct {
+    char **items; /**< The values in the order they were given */
+    size_t len;   /**< The amount of values */
+    size_t cap;   /**< The amount of values the array can hold. 0 if the array is not owned by the list, e.g. a static default */
+} cli_list;
+
 /**
  * @brief Union holding all possible data of a parsed option.
  */
@@ -194,6 +207,7 @@ typedef union {
     int64_t num_data;   /**< The numer data of the option */
     uint64_t unum_data; /**< The unsigned data of the option */
     bool bool_data;     /**< The boolean data of the option */
+    cli_list list_data; /**< The values of a list option */
 } cli_data;
 
 /**
@@ -202,7 +216,7 @@ typedef union {
 typedef struct {
     char short_arg;  /**< The shorthand version of the option. Set to 0 if not required */
     char *long_arg;  /**< The long version and name of the option. Required */
-    uint16_t params; /**< The params field of the option. See @ref ARG_MAKE */
+    uint64_t params; /**< The params field of the option. See @ref ARG_MAKE */
     cli_data *data;  /**< The data field of the option. After parsing holds the data passed down in the cli. Accessing fields not matching the type of the option is undefined behaviour */
     char *desc;      /**< Optional description to print in the help menu */
     char *arg_desc;  /**< Description/name of the parameter of the option. Only applicable to string and boolean options*/
@@ -235,6 +249,7 @@ typedef enum {
     string = 2,  /**< Indicates a string option */
     number = 4,  /**< Indicates a integer option */
     unumber = 8, /**< Indicates an unsigned integer option */
+    list = 16,   /**< Indicates a string option which can be given multiple times. A positional list takes all remaining positional arguments */
 } cli_option_type;
 
 /**
@@ -245,18 +260,378 @@ typedef struct {
     char *description; /**< The description of the action performed */
 } cli_example;
 
+/**
+ * @def CLI_INDEX_END
+ * @brief Marks the end of a chain in a @ref cli_index.
+ */
+#define CLI_INDEX_END UINT32_MAX
+
+/**
+ * @brief Lookup index over a zero-terminated @ref cli_option array. Resolves long and short names without scanning the options.
+ *
+ * Options sharing a bucket or a short_arg are chained in declaration order so options with the same name in different commands can coexist.
+ */
+typedef struct {
+    size_t opt_count;          /**< The amount of indexed options */
+    uint32_t mask;             /**< The amount of buckets minus one. The amount of buckets is always a power of two */
+    uint32_t *buckets;         /**< First option of each long name bucket */
+    uint32_t *hashes;          /**< Hash of the long name of each option */
+    uint32_t *long_next;       /**< Next option in the same long name bucket */
+    uint32_t short_head[256];  /**< First option of each short_arg */
+    uint32_t *short_next;      /**< Next option with the same short_arg */
+    uint32_t *positionals;     /**< Positional options in declaration order */
+    size_t pos_count;          /**< The amount of positional options */
+    uint32_t *required;        /**< Required options in declaration order */
+    size_t req_count;          /**< The amount of required options */
+    uint32_t *cmds;            /**< Command of each option encoded like in @ref CLI_ARG_MAKE */
+    uint32_t *sorted;          /**< The options ordered by their long name for prefix lookups. Only built once abbreviations are allowed, else NULL. The index storage always reserves room for it */
+} cli_index;
+
+/**
+ * @brief Lookup index over the names of the commands of a cli.
+ */
+typedef struct {
+    uint32_t mask;     /**< The amount of buckets minus one */
+    uint32_t *buckets; /**< First command of each bucket or NULL if the index is not built */
+    uint32_t *hashes;  /**< Hash of the name of each command */
+    uint32_t *next;    /**< Next command in the same bucket */
+    size_t max_depth;  /**< The largest amount of words in the name of a command */
+} cli_command_index;
+
+/**
+ * @brief Help menu of a single command rendered once and cached by the parser. The name of the binary is not part of the text but spliced in at the recorded offsets whenever the help menu is printed.
+ */
+typedef struct {
+    char *text;          /**< The rendered help menu without the name of the binary */
+    size_t len;          /**< The length of the text */
+    size_t *splices;     /**< Ascending offsets into the text at which the name of the binary is inserted */
+    size_t splice_count; /**< The amount of splices */
+} cli_help_text;
+
+/**
+ * @brief The source of the value of an option, which is also its rank when the layers are merged. Higher ranks win. Custom layers may use any rank between cli_source_none and cli_source_argv, e.g. cli_source_file + 1 for a user config above the system config.
+ */
+typedef enum {
+    cli_source_none = 0,     /**< The option was not set by any source */
+    cli_source_default = 16, /**< Defaults. Options set by them are not marked as matched */
+    cli_source_file = 32,    /**< The config file, see @ref cli_parser_set_config_file */
+    cli_source_env = 48,     /**< The environment, see @ref cli_parser_set_env_prefix */
+    cli_source_argv = 64,    /**< The arguments. Always the highest rank, layers have to rank below */
+} cli_source;
+
+/**
+ * @brief A value of a single option in a @ref cli_layer.
+ */
+typedef struct {
+    uint32_t opt_idx; /**< The index of the option */
+    cli_data value;   /**< The value. Entries of list options hold a single item in str_data */
+} cli_layer_entry;
+
+/**
+ * @brief Sparse set of option values coming from one source. See @ref cli_parser_set_layers.
+ */
+typedef struct {
+    cli_source source;        /**< The rank of the layer */
+    cli_layer_entry *entries; /**< The values in the order they were added */
+    size_t len;               /**< The amount of entries */
+    size_t cap;               /**< The amount of entries the array can hold */
+} cli_layer;
+
+/**
+ * @brief Context shared by all stages of the parser. Holds the tables of the cli together with their lengths, which are computed only once.
+ */
+typedef struct {
+    cli_command *commands;     /**< The zero-terminated array of commands or NULL */
+    cli_option *options;       /**< The zero-terminated array of options */
+    cli_exclusion *exclusions; /**< The optional zero-terminated array of exclusions */
+    cli_example *examples;     /**< The optional zero-terminated array of examples */
+    size_t cmd_count;          /**< The amount of commands */
+    size_t opt_count;          /**< The amount of options */
+    cli_index index;           /**< The lookup index of the options */
+    cli_command_index cmd_index; /**< The lookup index of the commands. Without it the commands are scanned */
+    const char *env_prefix;    /**< Prefix of the environment variables bound to the options or NULL. See @ref cli_parser_set_env_prefix */
+    size_t env_prefix_len;     /**< The length of the prefix */
+    const char *config_path;   /**< Path of the config file read beneath argv or NULL. See @ref cli_parser_set_config_file */
+    const char *snapshot_path; /**< Path of the snapshot of the last resolved parse or NULL. See @ref cli_parser_set_snapshot */
+    const cli_layer *layers;   /**< Additional sources merged beneath argv. See @ref cli_parser_set_layers */
+    size_t layer_count;        /**< The amount of additional sources */
+    bool abbreviations;        /**< Whether long options may be abbreviated to a unique prefix. See @ref cli_parser_allow_abbreviations */
+    cli_help_text **help;      /**< Help menus of the root command and every command, rendered on first use. Only set for parsers created with @ref cli_parser_compile */
+} cli_parser;
+
+/**
+ * @brief Represents the outcome of a parse. See @ref cli_parser_try_parse.
+ */
+typedef enum {
+    cli_ok = 0,                   /**< The command line was parsed successfully */
+    cli_help_requested,           /**< The help menu was requested with -h or --help */
+    cli_err_unknown_argument,     /**< An argument does not match any option */
+    cli_err_unexpected_argument,  /**< A value was given to a boolean option */
+    cli_err_missing_argument,     /**< An option requiring a value was given none */
+    cli_err_invalid_number,       /**< The value of a number or unumber option is not a valid number */
+    cli_err_too_many_positionals, /**< More positional arguments were given than there are positional options and no positional list takes the rest */
+    cli_err_missing_required,     /**< A required option was not given */
+    cli_err_exclusion_required,   /**< None of two required but mutually exclusive options was given */
+    cli_err_mutually_exclusive,   /**< Two mutually exclusive options were given */
+    cli_err_response_file,        /**< A response file given as @path could not be read or ends inside a quote */
+    cli_err_config_file,          /**< The config file could not be read or contains an invalid line */
+    cli_err_ambiguous_argument,   /**< An abbreviated long option matches more than one option */
+    cli_err_invalid_layer,        /**< A layer has a rank outside of the ranks beneath argv */
+} cli_status;
+
+/**
+ * @def CLI_ERROR_MSG_LEN
+ * @brief Size of the message buffer of a @ref cli_error.
+ */
+#define CLI_ERROR_MSG_LEN 256
+
+/**
+ * @brief Describes why a parse failed.
+ */
+typedef struct {
+    cli_status status;               /**< The outcome of the parse */
+    int argv_idx;                    /**< Index of the offending argument in the argv of the result, i.e. after response files were expanded, or -1 if the error is not caused by a single argument */
+    char message[CLI_ERROR_MSG_LEN]; /**< Human readable description of the error. Empty on success */
+} cli_error;
+
+/**
+ * @brief A block of memory an arena hands out allocations from.
+ */
+typedef struct cli_arena_block {
+    struct cli_arena_block *next; /**< The next block of the arena or NULL */
+    size_t cap;                   /**< The amount of bytes the block can hold */
+    size_t used;                  /**< The amount of bytes handed out from the block */
+} cli_arena_block;
+
+/**
+ * @brief Bump allocator for the memory allocated during a parse. Everything allocated from the arena is released at once with @ref cli_arena_reset or @ref cli_arena_free. The blocks are kept on reset, so parses reusing the arena do not allocate once it is warmed up.
+ */
+typedef struct {
+    cli_arena_block *head;    /**< The first block or NULL */
+    cli_arena_block *current; /**< The block allocations are currently served from */
+    size_t block_size;        /**< The minimum size of a new block */
+} cli_arena;
+
+/**
+ * @brief Allocator used by the library at runtime. See @ref cli_set_allocator.
+ */
+typedef struct {
+    void *(*malloc)(void *ctx, size_t size);             /**< Allocates size bytes. Returning NULL makes the library panic */
+    void *(*realloc)(void *ctx, void *ptr, size_t size); /**< Resizes memory obtained from malloc or realloc. ptr may be NULL */
+    void (*free)(void *ctx, void *ptr);                  /**< Releases memory obtained from malloc or realloc. ptr may be NULL */
+    void *ctx;                                           /**< Passed to every call of the allocator, e.g. a pool or statistics */
+} cli_allocator;
+
+/**
+ * @brief Contents of a file read during a parse, i.e. a response file given as @path or the config file. The values read from the file point into the contents.
+ */
+typedef struct {
+    char *data;  /**< The contents of the file or NULL if the file is empty */
+    size_t len;  /**< The length of the contents */
+    bool mapped; /**< Whether the contents are memory-mapped or allocated for the parse */
+} cli_response_file;
+
+/**
+ * @brief Result of a single call to @ref cli_parser_parse.
+ */
+typedef struct {
+    char *command;    /**< The name of the invoked command or NULL if the root command was invoked */
+    size_t cmd_idx;   /**< The invoked command as encoded in @ref CLI_ARG_MAKE. 1 for the root command */
+    cli_data *values; /**< Optional caller-supplied array with one entry per option. If set the parsed values are stored here instead of in the data field of the options. Entries of options that are not matched are left untouched */
+    bool *matched;    /**< Optional caller-supplied array with one entry per option. If set the matched state is stored here and the params of the options are not modified */
+    uint8_t *sources; /**< Optional caller-supplied array with one entry per option. If set it receives the @ref cli_source of the value of every option */
+    cli_error error;  /**< The outcome of the parse */
+    int argc;                 /**< The length of argv */
+    char **argv;              /**< The parsed arguments. If response files were expanded this is a new array whose entries point into the response files, else the given argv. Indices in the error refer to this array */
+    cli_response_file *files; /**< The response files read during the parse. Release them with @ref cli_result_free once the parsed values are no longer needed */
+    size_t file_count;        /**< The amount of response files */
+    cli_response_file config; /**< The config file read during the parse. Release it with @ref cli_result_free once the parsed values are no longer needed */
+    cli_response_file snapshot; /**< The snapshot the values were restored from. Release it with @ref cli_result_free once the parsed values are no longer needed */
+    cli_arena *arena;         /**< Optional caller-supplied arena. If set all memory allocated during the parse comes from the arena and stays valid until the arena is reset */
+} cli_result;
+
+/**
+ * @def CLI_INDEX_STORAGE(opt_count)
+ * @brief Evaluates to the amount of uint32_t an index over opt_count options needs at most. Use it to size static storage for @ref cli_parser_init_static.
+ * @param opt_count The amount of options
+ */
+#define CLI_INDEX_STORAGE(opt_count) (16 + (opt_count) * 11)
+
+/**
+ * @def CLI_COMMAND_INDEX_STORAGE(cmd_count)
+ * @brief Evaluates to the amount of uint32_t an index over cmd_count commands needs at most. Use it to size static storage for @ref cli_parser_init_static.
+ * @param cmd_count The amount of commands
+ */
+#define CLI_COMMAND_INDEX_STORAGE(cmd_count) (16 + (cmd_count) * 6)
+
+/**
+ * @def CLI_ONESHOT_INDEX_OPTIONS
+ * @brief The largest amount of options @ref cli_parse_opts and @ref cli_try_parse_opts index on the stack. Larger tables get an index allocated on every call, so compile them with @ref cli_parser_compile or @ref cli_parser_init_static instead.
+ */
+#ifndef CLI_ONESHOT_INDEX_OPTIONS
+#define CLI_ONESHOT_INDEX_OPTIONS 32
+#endif
+
+/**
+ * @def CLI_X_ENUM(id, ...)
+ * @brief Expands an entry of an X-macro table to its enumerator. See @ref CLI_OPTIONS.
+ */
+#define CLI_X_ENUM(id, ...) id,
+
+/**
+ * @def CLI_X_ENTRY(id, ...)
+ * @brief Expands an entry of an X-macro table to its initializer. See @ref CLI_OPTIONS.
+ */
+#define CLI_X_ENTRY(id, ...) {__VA_ARGS__},
+
+/**
+ * @def CLI_COMMANDS(name, LIST)
+ * @brief Defines the zero-terminated array of @ref command_t name from the X-macro LIST, together with an enum holding the index of every command, name_count and the static storage name_index for the lookup index.
+ * @param name The name of the array
+ * @param LIST A macro taking a macro X and calling X(id, command, desc) once per command
+ *
+ * The enumerators can be used in @ref CLI_ARG_MAKE_CMD and @ref CLI_CMD.
+ */
+#define CLI_COMMANDS(name, LIST)                        \
+    enum { LIST(CLI_X_ENUM) name##_count };             \
+    static cli_command name[] = {LIST(CLI_X_ENTRY){0}}; \
+    static uint32_t name##_index[CLI_COMMAND_INDEX_STORAGE(name##_count)]
+
+/**
+ * @def CLI_OPTIONS(name, LIST)
+ * @brief Defines the zero-terminated array of @ref option_t name from the X-macro LIST, together with an enum holding the index of every option, name_count and the static storage name_index for the lookup index.
+ * @param name The name of the array
+ * @param LIST A macro taking a macro X and calling X(id, short_arg, long_arg, params, data, desc, arg_desc) once per option
+ *
+ * The index of an option is also its position in the values and matched arrays of a @ref cli_result. Pass the tables to @ref CLI_PARSER_INIT.
+ */
+#define CLI_OPTIONS(name, LIST)                             \
+    enum { LIST(CLI_X_ENUM) name##_count };                 \
+    static cli_option name[] = {LIST(CLI_X_ENTRY){0}};      \
+    static uint32_t name##_index[CLI_INDEX_STORAGE(name##_count)]
+
+/**
+ * @def CLI_PARSER_INIT(parser, commands, options, exclusions, examples)
+ * @brief Initializes a parser from tables defined with @ref CLI_COMMANDS and @ref CLI_OPTIONS without allocating. See @ref cli_parser_init_static.
+ */
+#define CLI_PARSER_INIT(parser, commands, options, exclusions, examples) \
+    cli_parser_init_static(parser, commands, commands##_count, commands##_index, options, options##_count, options##_index, exclusions, examples)
+
 #ifdef CCLI_IMPLEMENTATION
 #include <errno.h>
-#include <limits.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <time.h>
 
-_Noreturn void cli_panic(const char *msg) {
+extern char **environ;
+
+#if defined(__APPLE__)
+#define CLI_STAT_MTIME_NSEC(st) ((st).st_mtimespec.tv_nsec)
+#define CLI_STAT_CTIME_NSEC(st) ((st).st_ctimespec.tv_nsec)
+#elif defined(__GLIBC__) && !defined(__USE_XOPEN2K8)
+#define CLI_STAT_MTIME_NSEC(st) ((st).st_mtimensec)
+#define CLI_STAT_CTIME_NSEC(st) ((st).st_ctimensec)
+#else
+#define CLI_STAT_MTIME_NSEC(st) ((st).st_mtim.tv_nsec)
+#define CLI_STAT_CTIME_NSEC(st) ((st).st_ctim.tv_nsec)
+#endif
+
+#ifdef __cplusplus
+#define CLI_NORETURN [[noreturn]]
+#else
+#define CLI_NORETURN _Noreturn
+#endif
+
+/**
+ * @brief The allocator installed with @ref cli_set_allocator. All functions are NULL while the default allocator is used.
+ */
+cli_allocator _cli_allocator = {NULL, NULL, NULL, NULL};
+
+/**
+ * @brief Installs an allocator used for all memory the library allocates from now on. Install it before the first allocation and do not change it while memory of the previous allocator is still in use, e.g. by a compiled parser.
+ * @param allocator The allocator to install. Its functions are copied. Set to NULL to return to malloc, realloc and free
+ * @note Ignored for allocation sites whose @ref CLI_MALLOC, @ref CLI_REALLOC or @ref CLI_FREE is overridden at compile time
+ */
+void cli_set_allocator(const cli_allocator *allocator) {
+    if (allocator == NULL) {
+        memset(&_cli_allocator, 0, sizeof(_cli_allocator));
+    } else {
+        _cli_allocator = *allocator;
+    }
+}
+
+/**
+ * @brief Allocates memory through the installed allocator.
+ * @param size The amount of bytes to allocate
+ * @return The allocated memory or NULL
+ */
+void *_cli_malloc(size_t size) {
+    return _cli_allocator.malloc != NULL ? _cli_allocator.malloc(_cli_allocator.ctx, size) : malloc(size);
+}
+
+/**
+ * @brief Reallocates memory through the installed allocator.
+ * @param ptr The memory to resize or NULL
+ * @param size The new size in bytes
+ * @return The resized memory or NULL
+ */
+void *_cli_realloc(void *ptr, size_t size) {
+    return _cli_allocator.realloc != NULL ? _cli_allocator.realloc(_cli_allocator.ctx, ptr, size) : realloc(ptr, size);
+}
+
+/**
+ * @brief Releases memory through the installed allocator.
+ * @param ptr The memory to release or NULL
+ */
+void _cli_free(void *ptr) {
+    if (_cli_allocator.free != NULL) {
+        _cli_allocator.free(_cli_allocator.ctx, ptr);
+    } else {
+        free(ptr);
+    }
+}
+
+/**
+ * @def CLI_MALLOC(size)
+ * @brief Allocates memory for the library. Defaults to the allocator installed with @ref cli_set_allocator. Define it before including the implementation to replace the allocator at compile time.
+ */
+#ifndef CLI_MALLOC
+#define CLI_MALLOC(size) _cli_malloc(size)
+#endif
+
+/**
+ * @def CLI_REALLOC(ptr, size)
+ * @brief Reallocates memory obtained from @ref CLI_MALLOC.
+ */
+#ifndef CLI_REALLOC
+#define CLI_REALLOC(ptr, size) _cli_realloc(ptr, size)
+#endif
+
+/**
+ * @def CLI_FREE(ptr)
+ * @brief Releases memory obtained from @ref CLI_MALLOC or @ref CLI_REALLOC.
+ */
+#ifndef CLI_FREE
+#define CLI_FREE(ptr) _cli_free(ptr)
+#endif
+
+/**
+ * @brief Releases memory the library returned to the caller, e.g. a rendered help menu.
+ * @param ptr The memory to release or NULL
+ */
+void cli_free(void *ptr) {
+    CLI_FREE(ptr);
+}
+
+CLI_NORETURN void cli_panic(const char *msg) {
     if (msg != NULL) {
         fprintf(stderr, "cli_panic: %s\n", msg);
     } else {
@@ -265,7 +640,7 @@ _Noreturn void cli_panic(const char *msg) {
     exit(1);
 }
 
-_Noreturn void cli_panicf(const char *msg, ...) {
+CLI_NORETURN void cli_panicf(const char *msg, ...) {
     va_list argptr;
     va_start(argptr, msg);
 
@@ -278,14 +653,14 @@ _Noreturn void cli_panicf(const char *msg, ...) {
     exit(1);
 }
 
-_Noreturn void cli_fatal(const char *bin, const char *msg) {
+CLI_NORETURN void cli_fatal(const char *bin, const char *msg) {
     if (msg != NULL) {
         fprintf(stderr, "%s: %s\n", bin, msg);
     }
     exit(1);
 }
 
-_Noreturn void cli_fatalf(const char *bin, const char *format, ...) {
+CLI_NORETURN void cli_fatalf(const char *bin, const char *format, ...) {
     va_list argptr;
     va_start(argptr, format);
 
@@ -298,7 +673,7 @@ _Noreturn void cli_fatalf(const char *bin, const char *format, ...) {
     exit(1);
 }
 
-_Noreturn void cli_fatalf_help(const char *bin, const char *format, ...) {
+CLI_NORETURN void cli_fatalf_help(const char *bin, const char *format, ...) {
     va_list argptr;
     va_start(argptr, format);
 
@@ -317,136 +692,157 @@ void cli_check_alloc(void *ptr) {
     }
 }
 
-bool cli_try_parse_int(char *num, int64_t *data) {
-    char *end_ptr;
-    errno = 0;
-    bool failed = false;
+/**
+ * @brief Returns whether the 8 characters packed in the given word are all decimal digits.
+ * @param chunk 8 characters loaded in memory order
+ * @return True if all characters are between '0' and '9', else false
+ */
+bool _cli_is_eight_digits(uint64_t chunk) {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
 
-    int64_t parsed = strtol(num, &end_ptr, 10);
+/**
+ * @brief Converts 8 decimal digits packed in a little endian word to their value with a handful of multiplications.
+ * @param chunk 8 decimal digits loaded in memory order
+ * @return The value of the digits
+ */
+uint32_t _cli_parse_eight_digits(uint64_t chunk) {
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) + (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return (uint32_t)chunk;
+}
 
-    if (end_ptr == num) {
-        failed = true;
-    } else if (errno == ERANGE && (parsed == LONG_MAX || parsed == LONG_MIN)) {
-        failed = true;
-    } else if (errno != 0 && num == 0) {
-        failed = true;
-    } else if (*end_ptr != '\0') {
-        failed = true;
-    }
+/**
+ * @brief Parses an unsigned number in a single pass. Accepts decimal digits, hexadecimal digits prefixed with 0x and binary digits prefixed with 0b.
+ * @param num The string to parse without sign
+ * @param len The length of the string
+ * @param data Set to the parsed value on success
+ * @return False if the string is empty, contains invalid digits or does not fit in 64 bits, else true
+ */
+bool _cli_parse_magnitude(const char *num, size_t len, uint64_t *data) {
+    uint64_t value = 0;
+    size_t idx = 0;
 
-    if (failed) {
-        if (strlen(num) <= 2 || num[0] != '0' || num[1] != 'x') {
-            failed = true;
-        } else {
-            failed = false;
-            char *end_ptr_hex;
-            parsed = strtol(num, &end_ptr_hex, 16);
-
-            if (end_ptr_hex == num) {
-                failed = true;
-            } else if ((parsed == LONG_MAX || parsed == LONG_MIN)) {
-                failed = true;
-            } else if (errno != 0 && num == 0) {
-                failed = true;
-            } else if (*end_ptr_hex != '\0') {
-                failed = true;
+    if (len > 2 && num[0] == '0' && (num[1] == 'x' || num[1] == 'X')) {
+        for (idx = 2; idx < len; idx++) {
+            char c = num[idx];
+            uint64_t digit;
+            if (c >= '0' && c <= '9') {
+                digit = c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                digit = c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                digit = c - 'A' + 10;
+            } else {
+                return false;
+            }
+            if (value >> 60 != 0) {
+                return false;
             }
+            value = (value << 4) | digit;
         }
+        *data = value;
+        return true;
     }
 
-    if (failed) {
-        if (strlen(num) <= 2 || num[0] != '0' || num[1] != 'b') {
-            return false;
+    if (len > 2 && num[0] == '0' && (num[1] == 'b' || num[1] == 'B')) {
+        for (idx = 2; idx < len; idx++) {
+            char c = num[idx];
+            if (c != '0' && c != '1') {
+                return false;
+            }
+            if (value >> 63 != 0) {
+                return false;
+            }
+            value = (value << 1) | (uint64_t)(c - '0');
         }
+        *data = value;
+        return true;
+    }
 
-        num += 2;
-
-        failed = false;
-        char *end_ptr_bin;
-        parsed = strtol(num, &end_ptr_bin, 2);
+    if (len == 0) {
+        return false;
+    }
 
-        if (end_ptr_bin == num) {
-            failed = true;
-        } else if ((parsed == LONG_MAX || parsed == LONG_MIN)) {
-            failed = true;
-        } else if (errno != 0 && num == 0) {
-            failed = true;
-        } else if (*end_ptr_bin != '\0') {
-            failed = true;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (len - idx >= 8) {
+        uint64_t chunk;
+        memcpy(&chunk, num + idx, sizeof(chunk));
+        if (!_cli_is_eight_digits(chunk)) {
+            break;
+        }
+        uint64_t digits = _cli_parse_eight_digits(chunk);
+        if (value > (UINT64_MAX - digits) / 100000000ULL) {
+            return false;
         }
+        value = value * 100000000ULL + digits;
+        idx += 8;
     }
+#endif
 
-    if (!failed) {
-        *data = parsed;
+    for (; idx < len; idx++) {
+        char c = num[idx];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        uint64_t digit = c - '0';
+        if (value > UINT64_MAX / 10 || (value == UINT64_MAX / 10 && digit > UINT64_MAX % 10)) {
+            return false;
+        }
+        value = value * 10 + digit;
     }
-
-    return !failed;
+    *data = value;
+    return true;
 }
 
-bool cli_try_parse_uint(char *num, uint64_t *data) {
-    char *end_ptr;
-    errno = 0;
-    bool failed = false;
-
-    uint64_t parsed = strtoll(num, &end_ptr, 10);
-
-    if (end_ptr == num) {
-        failed = true;
-    } else if (errno == ERANGE && (parsed == UINT64_MAX || parsed == UINT64_MAX)) {
-        failed = true;
-    } else if (errno != 0 && num == 0) {
-        failed = true;
-    } else if (*end_ptr != '\0') {
-        failed = true;
+/**
+ * @brief Parses a signed 64 bit number. Accepts an optional sign followed by decimal digits, hexadecimal digits prefixed with 0x or binary digits prefixed with 0b.
+ * @param num The string to parse
+ * @param data Set to the parsed value on success
+ * @return True if the whole string is a number that fits in an int64_t, else false
+ */
+bool cli_try_parse_int(char *num, int64_t *data) {
+    if (num == NULL) {
+        return false;
     }
-
-    if (failed) {
-        if (strlen(num) <= 2 || num[0] != '0' || num[1] != 'x') {
-            failed = true;
-        } else {
-            failed = false;
-            char *end_ptr_hex;
-            parsed = strtol(num, &end_ptr_hex, 16);
-
-            if (end_ptr_hex == num) {
-                failed = true;
-            } else if ((parsed == UINT64_MAX || parsed == UINT64_MAX)) {
-                failed = true;
-            } else if (errno != 0 && num == 0) {
-                failed = true;
-            } else if (*end_ptr_hex != '\0') {
-                failed = true;
-            }
-        }
+    bool negative = num[0] == '-';
+    if (num[0] == '-' || num[0] == '+') {
+        num++;
     }
 
-    if (failed) {
-        if (strlen(num) <= 2 || num[0] != '0' || num[1] != 'b') {
+    uint64_t magnitude;
+    if (!_cli_parse_magnitude(num, strlen(num), &magnitude)) {
+        return false;
+    }
+    if (negative) {
+        if (magnitude > (uint64_t)INT64_MAX + 1) {
             return false;
         }
-
-        num += 2;
-
-        failed = false;
-        char *end_ptr_bin;
-        parsed = strtol(num, &end_ptr_bin, 2);
-
-        if (end_ptr_bin == num) {
-            failed = true;
-        } else if ((parsed == UINT64_MAX || parsed == UINT64_MAX)) {
-            failed = true;
-        } else if (errno != 0 && num == 0) {
-            failed = true;
-        } else if (*end_ptr_bin != '\0') {
-            failed = true;
+        *data = magnitude == (uint64_t)INT64_MAX + 1 ? INT64_MIN : -(int64_t)magnitude;
+    } else {
+        if (magnitude > INT64_MAX) {
+            return false;
         }
+        *data = (int64_t)magnitude;
     }
+    return true;
+}
 
-    if (!failed) {
-        *data = parsed;
+/**
+ * @brief Parses an unsigned 64 bit number. Accepts an optional '+' followed by decimal digits, hexadecimal digits prefixed with 0x or binary digits prefixed with 0b.
+ * @param num The string to parse
+ * @param data Set to the parsed value on success
+ * @return True if the whole string is a number that fits in an uint64_t, else false
+ */
+bool cli_try_parse_uint(char *num, uint64_t *data) {
+    if (num == NULL) {
+        return false;
     }
-
-    return !failed;
+    if (num[0] == '+') {
+        num++;
+    }
+    return _cli_parse_magnitude(num, strlen(num), data);
 }
 
 bool cli_streq(const char *s1, const char *s2) {
@@ -491,7 +887,7 @@ int64_t cli_stridx(const char *s, char c) {
 /**
  * @brief Help option. Always present.
  */
-const cli_option help_opt = {'h', "help", CLI_ARG_MAKE_GLOBAL(boolean, false, false), NULL, "Show this help menu", NULL};
+const cli_option help_opt = {'h', (char *)"help", CLI_ARG_MAKE_GLOBAL(boolean, false, false), NULL, (char *)"Show this help menu", NULL};
 
 /**
  * @brief Represents all possible types of short options.
@@ -553,524 +949,2705 @@ size_t _cli_cmd_len(cli_command *commands) {
 }
 
 /**
- * @brief Validates a zero-terminated @ref option_t array. cli_panics if options are not valid
+ * @brief Initializes the parser context with the given tables. Counts the commands and options once. The lookup index is not built.
+ * @param parser The parser to initialize
+ * @param commands The zero-terminated array of @ref command_t or NULL
  * @param options The zero-terminated array of @ref option_t
+ * @param exclusions Optional zero-terminated array of @ref exclusion_t
+ * @param examples Optional zero-terminated array of examples
  */
-void _cli_validate_options(cli_option *options) {
-    for (size_t i = 0; i < _cli_opt_len(options); i++) {
-        cli_option opt = options[i];
+void _cli_parser_init(cli_parser *parser, cli_command *commands, cli_option *options, cli_exclusion *exclusions, cli_example *examples) {
+    parser->commands = commands;
+    parser->options = options;
+    parser->exclusions = exclusions;
+    parser->examples = examples;
+    parser->cmd_count = _cli_cmd_len(commands);
+    parser->opt_count = _cli_opt_len(options);
+    memset(&parser->index, 0, sizeof(parser->index));
+    memset(&parser->cmd_index, 0, sizeof(parser->cmd_index));
+    parser->env_prefix = NULL;
+    parser->env_prefix_len = 0;
+    parser->config_path = NULL;
+    parser->snapshot_path = NULL;
+    parser->layers = NULL;
+    parser->layer_count = 0;
+    parser->abbreviations = false;
+    parser->help = NULL;
+}
+
+/**
+ * @brief Returns the command of the given option.
+ * @param opt The option
+ * @return The command encoded in the params of the option
+ */
+uint32_t _cli_opt_cmd(const cli_option *opt) {
+    return (uint32_t)CLI_ARG_CMD(opt->params);
+}
+
+/**
+ * @brief Validates the options of the parser. cli_panics if options are not valid
+ * @param parser The parser holding the zero-terminated array of @ref option_t
+ */
+void _cli_validate_options(const cli_parser *parser) {
+    for (size_t i = 0; i < parser->opt_count; i++) {
+        cli_option opt = parser->options[i];
         if (opt.long_arg == NULL) {
             cli_panicf("Invalid option at index %lu. Long option is always required!", i);
         }
         if (CLI_ARG_TYPE(opt.params) != boolean && !(CLI_ARG_POSITIONAL(opt.params)) && opt.arg_desc == NULL) {
             cli_panicf("Invalid option %s. If option is not boolean arg_desc is required!", opt.long_arg);
         }
+        if (_cli_opt_cmd(&opt) > parser->cmd_count + 1) {
+            cli_panicf("Invalid option %s. The command of the option does not exist!", opt.long_arg);
+        }
     }
 }
 
 /**
  * @brief Return whether the given option is relevant in the context of the given command.
- * @param arg_opt The params of the option to check
+ * @param opt The option to check
  * @param commands The zero-terminated array of @ref command_t
  * @param command Name of the current command
  * @return True if the option is relevant, else false
  */
-bool _cli_arg_relevant(uint32_t arg_opt, cli_command *commands, char *command) {
-    if (CLI_ARG_GLOBAL(arg_opt)) {
+bool _cli_arg_relevant(const cli_option *opt, cli_command *commands, char *command) {
+    uint32_t cmd = _cli_opt_cmd(opt);
+    if (cmd == 0) {
         return true;
-    } else if (CLI_ARG_ROOT(arg_opt)) {
+    } else if (cmd == 1) {
         return command == NULL;
     }
-    return cli_streq(commands[CLI_ARG_CMD_IDX(arg_opt)].command, command);
+    return cli_streq(commands[cmd - 2].command, command);
 }
 
 /**
- * @brief Calculates the max length of the long arg in all of the given options in the context of the given command.
- * @param options The zero-terminated array of @ref option_t
- * @param commands The zero-terminated array of @ref command_t
- * @param command Name of the current command
- * @return The length of the longest option name + arg_desc
+ * @brief Returns whether the given option is part of the given command.
+ * @param index The index holding the command of the option
+ * @param opt_idx The index of the option
+ * @param cmd_idx The index of the command
+ * @return True if the option is global or belongs to the command, else false
  */
-size_t _cli_max_long_arg_len(cli_option *options, cli_command *commands, char *command) {
-    size_t max = 4; // Hardcoded to the word "help"
+bool _cli_opt_in_cmd(const cli_index *index, uint32_t opt_idx, uint64_t cmd_idx) {
+    return index->cmds[opt_idx] == 0 || index->cmds[opt_idx] == cmd_idx;
+}
 
-    for (size_t i = 0; i < _cli_opt_len(options); i++) {
-        cli_option opt = options[i];
-        if (!_cli_arg_relevant(opt.params, commands, command)) {
-            continue;
-        }
-        if (opt.long_arg == NULL) {
-            continue;
-        }
-        size_t len = strlen(opt.long_arg);
-        if (opt.arg_desc != NULL) {
-            len += 3 + strlen(opt.arg_desc);
-        }
-        if (len > max) {
-            max = len;
-        }
+/**
+ * @brief Continues an FNV-1a hash with the first len characters of the given string. Hashing a string in parts yields the hash of the whole string.
+ * @param hash The hash of everything before the string
+ * @param s The string to hash
+ * @param len The amount of characters to hash
+ * @return The hash including the string
+ */
+uint32_t _cli_hash_continue(uint32_t hash, const char *s, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ (unsigned char)s[i]) * 16777619u;
     }
+    return hash;
+}
 
-    return max;
+/**
+ * @brief Hashes the first len characters of the given string (FNV-1a).
+ * @param s The string to hash
+ * @param len The amount of characters to hash
+ * @return The hash of the string
+ */
+uint32_t _cli_hash(const char *s, size_t len) {
+    return _cli_hash_continue(2166136261u, s, len);
 }
 
 /**
- * @brief Calculates the amount of positional options in the context of the given command.
- * @param options The zero-terminated array of @ref option_t
- * @param commands The zero-terminated array of @ref command_t
- * @param command Name of the current command
- * @return The amount of positional options
+ * @brief Returns the amount of buckets of an index over the given amount of names.
+ * @param count The amount of names to index
+ * @return The smallest power of two which is at least 16 and twice the amount of names
  */
-size_t _cli_pos_args_len(cli_option *options, cli_command *commands, char *command) {
-    size_t count = 0;
-    for (size_t i = 0; i < _cli_opt_len(options); i++) {
-        if (CLI_ARG_POSITIONAL(options[i].params) && _cli_arg_relevant(options[i].params, commands, command)) {
-            count++;
-        }
+size_t _cli_index_bucket_count(size_t count) {
+    if (count >= CLI_INDEX_END / 7) {
+        cli_panicf("Too many entries to index: %lu", count);
     }
-    return count;
+    size_t bucket_count = 16;
+    while (bucket_count < count * 2) {
+        bucket_count <<= 1;
+    }
+    return bucket_count;
 }
 
 /**
- * @brief Prints the help menu.
- * @param commands All commands of the cli. Set to NULL if there are no commands else a zero-terminated array of @ref command_t
- * @param command The command to print the help menu of. Set to NULL to print help for the root command
- * @param options All options of the cli as a zero-terminated array of @ref option_t
- * @param argv The argv array
- * @param examples Optional zero-terminated array of examples
+ * @brief Moves an option down the heap of @ref _cli_index_sort until it is ordered.
+ * @param items The heap of option indices
+ * @param root The position of the option to move
+ * @param count The amount of options in the heap
+ * @param options The array of @ref option_t
  */
-void cli_help(cli_command *commands, char *command, cli_option *options, char *argv[], cli_example *examples) {
-    uint32_t max_len = _cli_max_long_arg_len(options, commands, command);
-    size_t num_options = _cli_opt_len(options);
-    size_t num_commands = _cli_cmd_len(commands);
-    printf("Usage: \n");
-    if (num_commands > 0) {
-        if (command == NULL) {
-            printf("\t%s [command]\n", argv[0]);
+void _cli_index_sift_down(uint32_t *items, size_t root, size_t count, cli_option *options) {
+    while (2 * root + 1 < count) {
+        size_t child = 2 * root + 1;
+        if (child + 1 < count && strcmp(options[items[child]].long_arg, options[items[child + 1]].long_arg) < 0) {
+            child++;
         }
+        if (strcmp(options[items[root]].long_arg, options[items[child]].long_arg) >= 0) {
+            return;
+        }
+        uint32_t tmp = items[root];
+        items[root] = items[child];
+        items[child] = tmp;
+        root = child;
     }
-    printf("\t%s ", argv[0]);
-    if (num_commands > 0 && command != NULL) {
-        printf("%s ", command);
-    }
-    printf("[options] ");
+}
+
+/**
+ * @brief Orders option indices by the long names of the options in place (heapsort, so no extra storage is needed).
+ * @param items The option indices
+ * @param count The amount of option indices
+ * @param options The array of @ref option_t
+ */
+void _cli_index_sort(uint32_t *items, size_t count, cli_option *options) {
+    for (size_t i = count / 2; i-- > 0;) {
+        _cli_index_sift_down(items, i, count, options);
+    }
+    for (size_t end = count; end-- > 1;) {
+        uint32_t tmp = items[0];
+        items[0] = items[end];
+        items[end] = tmp;
+        _cli_index_sift_down(items, 0, end, options);
+    }
+}
+
+/**
+ * @brief Builds the lookup index of the first opt_count options of the given array into the given storage.
+ * @param index The index to build
+ * @param options The array of @ref option_t
+ * @param opt_count The amount of options to index
+ * @param block Storage for the index holding at least @ref CLI_INDEX_STORAGE(opt_count) entries
+ */
+void _cli_index_build_into(cli_index *index, cli_option *options, size_t opt_count, uint32_t *block) {
+    size_t bucket_count = _cli_index_bucket_count(opt_count);
+    index->opt_count = opt_count;
+    index->mask = bucket_count - 1;
+    index->buckets = block;
+    index->hashes = index->buckets + bucket_count;
+    index->long_next = index->hashes + opt_count;
+    index->short_next = index->long_next + opt_count;
+    index->positionals = index->short_next + opt_count;
+    index->pos_count = 0;
+    index->required = index->positionals + opt_count;
+    index->req_count = 0;
+    index->cmds = index->required + opt_count;
+    index->sorted = NULL;
+
+    for (size_t i = 0; i < bucket_count; i++) {
+        index->buckets[i] = CLI_INDEX_END;
+    }
+    for (size_t i = 0; i < 256; i++) {
+        index->short_head[i] = CLI_INDEX_END;
+    }
+
+    // Insert back to front so every chain ends up in declaration order
+    for (size_t i = opt_count; i-- > 0;) {
+        cli_option opt = options[i];
+        index->hashes[i] = opt.long_arg != NULL ? _cli_hash(opt.long_arg, strlen(opt.long_arg)) : 0;
+        index->long_next[i] = index->buckets[index->hashes[i] & index->mask];
+        index->buckets[index->hashes[i] & index->mask] = i;
+        index->short_next[i] = CLI_INDEX_END;
+        index->cmds[i] = _cli_opt_cmd(&opt);
+        if (opt.short_arg != 0) {
+            index->short_next[i] = index->short_head[(unsigned char)opt.short_arg];
+            index->short_head[(unsigned char)opt.short_arg] = i;
+        }
+    }
+
+    for (size_t i = 0; i < opt_count; i++) {
+        if (CLI_ARG_POSITIONAL(options[i].params)) {
+            index->positionals[index->pos_count++] = i;
+        }
+        if (CLI_ARG_REQUIRED(options[i].params)) {
+            index->required[index->req_count++] = i;
+        }
+    }
+}
+
+/**
+ * @brief Builds the lookup index of the first opt_count options of the given array.
+ * @param index The index to build. Release it with @ref cli_index_free
+ * @param options The array of @ref option_t
+ * @param opt_count The amount of options to index
+ */
+void _cli_index_build(cli_index *index, cli_option *options, size_t opt_count) {
+    uint32_t *block = (uint32_t *)CLI_MALLOC(sizeof(uint32_t) * (_cli_index_bucket_count(opt_count) + opt_count * 7));
+    cli_check_alloc(block);
+    _cli_index_build_into(index, options, opt_count, block);
+}
+
+/**
+ * @brief Builds the lookup index of a zero-terminated @ref option_t array. The index stays valid as long as the array is not modified (except for the matched bit).
+ * @param index The index to build. Release it with @ref cli_index_free
+ * @param options The zero-terminated array of @ref option_t
+ */
+void cli_index_build(cli_index *index, cli_option *options) {
+    _cli_index_build(index, options, _cli_opt_len(options));
+}
+
+/**
+ * @brief Releases the memory held by an index built with @ref cli_index_build.
+ * @param index The index to release
+ */
+void cli_index_free(cli_index *index) {
+    CLI_FREE(index->buckets);
+    index->buckets = NULL;
+    index->opt_count = 0;
+    index->pos_count = 0;
+    index->req_count = 0;
+}
+
+/**
+ * @brief Builds the lookup index of the first cmd_count commands of the given array into the given storage.
+ * @param index The index to build
+ * @param commands The array of @ref command_t
+ * @param cmd_count The amount of commands to index
+ * @param block Storage for the index holding at least @ref CLI_COMMAND_INDEX_STORAGE(cmd_count) entries
+ */
+void _cli_command_index_build_into(cli_command_index *index, cli_command *commands, size_t cmd_count, uint32_t *block) {
+    size_t bucket_count = _cli_index_bucket_count(cmd_count);
+    index->mask = bucket_count - 1;
+    index->buckets = block;
+    index->hashes = index->buckets + bucket_count;
+    index->next = index->hashes + cmd_count;
+
+    index->max_depth = 0;
+
+    for (size_t i = 0; i < bucket_count; i++) {
+        index->buckets[i] = CLI_INDEX_END;
+    }
+    // Insert back to front so the first of two commands with the same name wins like in a scan
+    for (size_t i = cmd_count; i-- > 0;) {
+        const char *name = commands[i].command;
+        size_t depth = 1;
+        size_t len = 0;
+        for (; name[len] != 0; len++) {
+            depth += name[len] == ' ';
+        }
+        if (depth > index->max_depth) {
+            index->max_depth = depth;
+        }
+        index->hashes[i] = _cli_hash(name, len);
+        index->next[i] = index->buckets[index->hashes[i] & index->mask];
+        index->buckets[index->hashes[i] & index->mask] = i;
+    }
+}
+
+/**
+ * @brief Finds the command with the given name. Uses the command index of the parser if it is built, else scans the commands.
+ * @param parser The parser holding the commands
+ * @param name The name to look up
+ * @return The index of the command or @ref CLI_INDEX_END if there is no such command
+ */
+uint32_t _cli_find_command(const cli_parser *parser, const char *name) {
+    const cli_command_index *index = &parser->cmd_index;
+    if (index->buckets == NULL) {
+        for (size_t i = 0; i < parser->cmd_count; i++) {
+            if (cli_streq(parser->commands[i].command, name)) {
+                return i;
+            }
+        }
+        return CLI_INDEX_END;
+    }
+    uint32_t hash = _cli_hash(name, strlen(name));
+    for (uint32_t i = index->buckets[hash & index->mask]; i != CLI_INDEX_END; i = index->next[i]) {
+        if (index->hashes[i] == hash && cli_streq(parser->commands[i].command, name)) {
+            return i;
+        }
+    }
+    return CLI_INDEX_END;
+}
+
+/**
+ * @brief Returns where the value of the given option is stored for the current parse.
+ * @param parser The parser holding the options
+ * @param result The result of the current parse
+ * @param opt_idx The index of the option
+ * @return The entry in the values of the result if set, else the data field of the option
+ */
+cli_data *_cli_value(const cli_parser *parser, cli_result *result, uint32_t opt_idx) {
+    return result->values != NULL ? &result->values[opt_idx] : parser->options[opt_idx].data;
+}
+
+/**
+ * @brief Marks the given option as matched for the current parse.
+ * @param parser The parser holding the options
+ * @param result The result of the current parse
+ * @param opt_idx The index of the option
+ */
+void _cli_set_matched(const cli_parser *parser, cli_result *result, uint32_t opt_idx) {
+    if (result->matched != NULL) {
+        result->matched[opt_idx] = true;
+    } else {
+        parser->options[opt_idx].params = CLI_ARG_SET_MATCHED(parser->options[opt_idx].params);
+    }
+}
+
+/**
+ * @brief Returns whether the given option is matched in the current parse.
+ * @param parser The parser holding the options
+ * @param result The result of the current parse
+ * @param opt_idx The index of the option
+ * @return True if the option is matched, else false
+ */
+bool _cli_is_matched(const cli_parser *parser, const cli_result *result, uint32_t opt_idx) {
+    if (result->matched != NULL) {
+        return result->matched[opt_idx];
+    }
+    return CLI_ARG_MATCHED(parser->options[opt_idx].params);
+}
+
+/**
+ * @brief Records an error in the result of the current parse.
+ * @param result The result of the current parse
+ * @param status The kind of error
+ * @param argv_idx The index of the offending argument or -1
+ * @param format The format of the error message
+ * @return Always false
+ */
+bool _cli_fail(cli_result *result, cli_status status, int argv_idx, const char *format, ...) {
+    va_list argptr;
+    va_start(argptr, format);
+    result->error.status = status;
+    result->error.argv_idx = argv_idx;
+    vsnprintf(result->error.message, CLI_ERROR_MSG_LEN, format, argptr);
+    va_end(argptr);
+    return false;
+}
+
+/**
+ * @brief Calculates the max length of the long arg in all of the given options in the context of the given command.
+ * @param parser The parser holding the options and commands
+ * @param command Name of the current command
+ * @return The length of the longest option name + arg_desc
+ */
+size_t _cli_max_long_arg_len(const cli_parser *parser, char *command) {
+    size_t max = 4; // Hardcoded to the word "help"
+
+    for (size_t i = 0; i < parser->opt_count; i++) {
+        cli_option opt = parser->options[i];
+        if (!_cli_arg_relevant(&parser->options[i], parser->commands, command)) {
+            continue;
+        }
+        if (opt.long_arg == NULL) {
+            continue;
+        }
+        size_t len = strlen(opt.long_arg);
+        if (opt.arg_desc != NULL) {
+            len += 3 + strlen(opt.arg_desc);
+        }
+        if (len > max) {
+            max = len;
+        }
+    }
+
+    return max;
+}
+
+/**
+ * @brief Calculates the amount of positional options in the context of the given command.
+ * @param parser The parser holding the options and commands
+ * @param command Name of the current command
+ * @return The amount of positional options
+ */
+size_t _cli_pos_args_len(const cli_parser *parser, char *command) {
+    size_t count = 0;
+    for (size_t i = 0; i < parser->opt_count; i++) {
+        if (CLI_ARG_POSITIONAL(parser->options[i].params) && _cli_arg_relevant(&parser->options[i], parser->commands, command)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the name of the given command relative to a parent command if it is a direct subcommand of it.
+ * @param name The name of the command to check
+ * @param command Name of the parent command or NULL for the root command
+ * @return The last word of the name if the command is a direct subcommand, else NULL
+ */
+const char *_cli_subcommand_name(const char *name, const char *command) {
+    if (command != NULL) {
+        size_t len = strlen(command);
+        if (strncmp(name, command, len) != 0 || name[len] != ' ') {
+            return NULL;
+        }
+        name += len + 1;
+    }
+    return strchr(name, ' ') == NULL ? name : NULL;
+}
+
+/**
+ * @brief Calculates the amount of direct subcommands of the given command.
+ * @param parser The parser holding the commands
+ * @param command Name of the current command
+ * @return The amount of direct subcommands
+ */
+size_t _cli_subcommands_len(const cli_parser *parser, char *command) {
+    size_t count = 0;
+    for (size_t i = 0; i < parser->cmd_count; i++) {
+        count += _cli_subcommand_name(parser->commands[i].command, command) != NULL;
+    }
+    return count;
+}
+
+/**
+ * @brief Growable buffer the help menu is rendered into.
+ */
+typedef struct {
+    char *data; /**< The zero-terminated contents of the buffer */
+    size_t len; /**< The amount of bytes in the buffer without the terminator */
+    size_t cap; /**< The amount of bytes allocated for the buffer */
+} cli_buffer;
+
+/**
+ * @brief Makes sure that the given buffer can hold at least extra more bytes and the terminator.
+ * @param buf The buffer to grow
+ * @param extra The amount of bytes which will be appended
+ */
+void _cli_buf_reserve(cli_buffer *buf, size_t extra) {
+    if (buf->len + extra + 1 <= buf->cap) {
+        return;
+    }
+    size_t cap = buf->cap == 0 ? 1024 : buf->cap;
+    while (cap < buf->len + extra + 1) {
+        cap *= 2;
+    }
+    buf->data = (char *)CLI_REALLOC(buf->data, cap);
+    cli_check_alloc(buf->data);
+    buf->cap = cap;
+}
+
+/**
+ * @brief Appends len bytes of the given string to the buffer.
+ * @param buf The buffer to append to
+ * @param str The bytes to append
+ * @param len The amount of bytes to append
+ */
+void _cli_buf_append(cli_buffer *buf, const char *str, size_t len) {
+    _cli_buf_reserve(buf, len);
+    memcpy(buf->data + buf->len, str, len);
+    buf->len += len;
+    buf->data[buf->len] = 0;
+}
+
+/**
+ * @brief Appends the given zero-terminated string to the buffer. NULL is appended as "(null)" like printf does.
+ * @param buf The buffer to append to
+ * @param str The string to append
+ */
+void _cli_buf_puts(cli_buffer *buf, const char *str) {
+    if (str == NULL) {
+        str = "(null)";
+    }
+    _cli_buf_append(buf, str, strlen(str));
+}
+
+/**
+ * @brief Appends count copies of the given character to the buffer.
+ * @param buf The buffer to append to
+ * @param c The character to append
+ * @param count How often the character is appended
+ */
+void _cli_buf_fill(cli_buffer *buf, char c, size_t count) {
+    _cli_buf_reserve(buf, count);
+    memset(buf->data + buf->len, c, count);
+    buf->len += count;
+    buf->data[buf->len] = 0;
+}
+
+/**
+ * @brief Appends the given string and pads it with spaces to the given width.
+ * @param buf The buffer to append to
+ * @param str The string to append
+ * @param width The width of the column
+ */
+void _cli_buf_pad(cli_buffer *buf, const char *str, size_t width) {
+    size_t len = strlen(str);
+    _cli_buf_append(buf, str, len);
+    if (len < width) {
+        _cli_buf_fill(buf, ' ', width - len);
+    }
+}
+
+/**
+ * @brief Appends the name of the binary to the buffer or, if splices are recorded, the current offset to the splices.
+ * @param buf The buffer to append to
+ * @param bin The name of the binary
+ * @param splices Optional buffer collecting the offsets at which the name of the binary belongs
+ */
+void _cli_buf_bin(cli_buffer *buf, const char *bin, cli_buffer *splices) {
+    if (splices == NULL) {
+        _cli_buf_puts(buf, bin);
+        return;
+    }
+    _cli_buf_append(splices, (const char *)&buf->len, sizeof(buf->len));
+}
+
+/**
+ * @brief Renders the help menu into the given buffer.
+ * @param parser The parser holding the tables of the cli
+ * @param command The command to render the help menu of. Set to NULL to render help for the root command
+ * @param bin The name of the binary as shown in the usage
+ * @param buf The buffer to append the help menu to
+ * @param splices Optional buffer collecting the offsets of the name of the binary. If set the name itself is left out of the help menu
+ */
+void _cli_help_render(const cli_parser *parser, char *command, const char *bin, cli_buffer *buf, cli_buffer *splices) {
+    cli_command *commands = parser->commands;
+    cli_option *options = parser->options;
+    cli_example *examples = parser->examples;
+    size_t max_len = _cli_max_long_arg_len(parser, command);
+    size_t num_options = parser->opt_count;
+    size_t num_commands = parser->cmd_count;
+    size_t num_subcommands = _cli_subcommands_len(parser, command);
+    _cli_buf_puts(buf, "Usage: \n");
+    if (num_subcommands > 0) {
+        _cli_buf_puts(buf, "\t");
+        _cli_buf_bin(buf, bin, splices);
+        if (command != NULL) {
+            _cli_buf_puts(buf, " ");
+            _cli_buf_puts(buf, command);
+        }
+        _cli_buf_puts(buf, " [command]\n");
+    }
+    _cli_buf_puts(buf, "\t");
+    _cli_buf_bin(buf, bin, splices);
+    _cli_buf_puts(buf, " ");
+    if (num_commands > 0 && command != NULL) {
+        _cli_buf_puts(buf, command);
+        _cli_buf_puts(buf, " ");
+    }
+    _cli_buf_puts(buf, "[options] ");
     for (size_t i = 0; i < num_options; i++) {
         cli_option opt = options[i];
-        if (CLI_ARG_POSITIONAL(opt.params) && _cli_arg_relevant(opt.params, commands, command)) {
-            printf("%s ", opt.long_arg);
+        if (CLI_ARG_POSITIONAL(opt.params) && _cli_arg_relevant(&options[i], commands, command)) {
+            _cli_buf_puts(buf, opt.long_arg);
+            _cli_buf_puts(buf, " ");
         }
     }
-    if (num_commands > 0 && command == NULL) {
-        printf("\n\nAvailable commands:\n");
+    if (num_subcommands > 0) {
+        _cli_buf_puts(buf, "\n\nAvailable commands:\n");
         for (size_t i = 0; i < num_commands; i++) {
             cli_command cmd = commands[i];
-            char *padded_cmd = (char *)malloc(sizeof(char) * max_len + 1);
-            cli_check_alloc(padded_cmd);
-            memset(padded_cmd, ' ', max_len);
-            memcpy(padded_cmd, cmd.command, strlen(cmd.command));
-            padded_cmd[max_len] = 0;
-            printf("\t%s      %s\n", padded_cmd, cmd.desc);
-
-            free(padded_cmd);
+            const char *name = _cli_subcommand_name(cmd.command, command);
+            if (name == NULL) {
+                continue;
+            }
+            _cli_buf_puts(buf, "\t");
+            _cli_buf_pad(buf, name, max_len);
+            _cli_buf_puts(buf, "      ");
+            _cli_buf_puts(buf, cmd.desc);
+            _cli_buf_puts(buf, "\n");
         }
     } else {
-        putchar('\n');
+        _cli_buf_puts(buf, "\n");
     }
-    printf("\nAvailable options:\n");
+    _cli_buf_puts(buf, "\nAvailable options:\n");
     for (size_t i = 0; i < num_options; i++) {
         cli_option opt = options[i];
-        if (CLI_ARG_POSITIONAL(opt.params) || !_cli_arg_relevant(opt.params, commands, command)) {
+        if (CLI_ARG_POSITIONAL(opt.params) || !_cli_arg_relevant(&options[i], commands, command)) {
             continue;
         }
-        char *padded_long;
-        if (opt.long_arg != NULL) {
-            padded_long = (char *)malloc(sizeof(char) * max_len + 1);
-            cli_check_alloc(padded_long);
-            memset(padded_long, ' ', max_len);
-            memcpy(padded_long, opt.long_arg, strlen(opt.long_arg));
-            padded_long[max_len] = 0;
-            if (opt.arg_desc != NULL) {
-                padded_long[strlen(opt.long_arg) + 1] = '<';
-                memcpy(padded_long + strlen(opt.long_arg) + 2, opt.arg_desc, strlen(opt.arg_desc));
-                padded_long[strlen(opt.long_arg) + 1 + strlen(opt.arg_desc) + 1] = '>';
-            }
+        if (opt.short_arg == 0) {
+            _cli_buf_puts(buf, "\t   --");
         } else {
-            padded_long = (char *)malloc(sizeof(char) * max_len + 3);
-            cli_check_alloc(padded_long);
-            memset(padded_long, ' ', max_len + 3);
+            char short_opt[] = {'\t', '-', opt.short_arg, ' ', '-', '-'};
+            _cli_buf_append(buf, short_opt, sizeof(short_opt));
         }
-
-        if (opt.short_arg == 0) {
-            printf("\t  ");
+        if (opt.long_arg == NULL) {
+            _cli_buf_fill(buf, ' ', max_len + 2);
+        } else if (opt.arg_desc != NULL) {
+            size_t start = buf->len;
+            _cli_buf_puts(buf, opt.long_arg);
+            _cli_buf_puts(buf, " <");
+            _cli_buf_puts(buf, opt.arg_desc);
+            _cli_buf_puts(buf, ">");
+            _cli_buf_fill(buf, ' ', max_len - (buf->len - start));
         } else {
-            printf("\t-%c", opt.short_arg);
+            _cli_buf_pad(buf, opt.long_arg, max_len);
         }
-        printf(" --%s %s\n", padded_long, opt.desc);
-
-        free(padded_long);
+        _cli_buf_puts(buf, " ");
+        _cli_buf_puts(buf, opt.desc);
+        _cli_buf_puts(buf, "\n");
     }
 
-    char *padded_long;
-    padded_long = (char *)malloc(sizeof(char) * max_len + 1);
-    cli_check_alloc(padded_long);
-    memset(padded_long, ' ', max_len);
-    memcpy(padded_long, help_opt.long_arg, strlen(help_opt.long_arg));
-    padded_long[max_len] = 0;
-
-    printf("\t-%c", help_opt.short_arg);
-    printf(" --%s %s\n", padded_long, help_opt.desc);
-
-    free(padded_long);
+    char help_short[] = {'\t', '-', help_opt.short_arg, ' ', '-', '-'};
+    _cli_buf_append(buf, help_short, sizeof(help_short));
+    _cli_buf_pad(buf, help_opt.long_arg, max_len);
+    _cli_buf_puts(buf, " ");
+    _cli_buf_puts(buf, help_opt.desc);
+    _cli_buf_puts(buf, "\n");
 
-    if (_cli_pos_args_len(options, commands, command) > 0) {
-        printf("\nPositional options:\n");
+    if (_cli_pos_args_len(parser, command) > 0) {
+        _cli_buf_puts(buf, "\nPositional options:\n");
         for (size_t i = 0; i < num_options; i++) {
             cli_option opt = options[i];
-            if (!(CLI_ARG_POSITIONAL(opt.params)) || !_cli_arg_relevant(opt.params, commands, command)) {
+            if (!(CLI_ARG_POSITIONAL(opt.params)) || !_cli_arg_relevant(&options[i], commands, command)) {
+                continue;
+            }
+            _cli_buf_puts(buf, "\t");
+            _cli_buf_pad(buf, opt.long_arg, max_len);
+            _cli_buf_puts(buf, "      ");
+            _cli_buf_puts(buf, opt.desc);
+            _cli_buf_puts(buf, "\n");
+        }
+    }
+
+    if (examples != NULL) {
+        _cli_buf_puts(buf, "\nExamples:\n");
+        cli_example example;
+        size_t idx = 0;
+        while ((example = examples[idx++]).options != NULL) {
+            _cli_buf_bin(buf, bin, splices);
+            _cli_buf_puts(buf, " ");
+            _cli_buf_puts(buf, example.options);
+            _cli_buf_puts(buf, "\t");
+            _cli_buf_puts(buf, example.description);
+            _cli_buf_puts(buf, "\n");
+        }
+    }
+
+    _cli_buf_puts(buf, "\n\nUse `");
+    _cli_buf_bin(buf, bin, splices);
+    _cli_buf_puts(buf, " [command] --help` to get help for a specific command\n");
+}
+
+/**
+ * @brief Writes all of the given buffers to stdout. Partial writes are continued until everything is written or an error occurs.
+ * @param iov The buffers to write. Modified while writing
+ * @param count The amount of buffers
+ */
+void _cli_writev_stdout(struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t written = writev(STDOUT_FILENO, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
                 continue;
             }
-            char *padded_long;
-            padded_long = (char *)malloc(sizeof(char) * max_len + 1);
-            cli_check_alloc(padded_long);
-            memset(padded_long, ' ', max_len);
-            memcpy(padded_long, opt.long_arg, strlen(opt.long_arg));
-            padded_long[max_len] = 0;
-
-            printf("\t%s      %s\n", padded_long, opt.desc);
-
-            free(padded_long);
+            return;
+        }
+        size_t left = (size_t)written;
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+}
+
+/**
+ * @brief Writes all of the given bytes to stdout with as few write calls as possible. Pending output of stdio is flushed first to keep the order intact.
+ * @param data The bytes to write
+ * @param len The amount of bytes to write
+ */
+void _cli_write_stdout(const char *data, size_t len) {
+    struct iovec iov = {(void *)data, len};
+    fflush(stdout);
+    _cli_writev_stdout(&iov, 1);
+}
+
+/**
+ * @brief Returns the slot of the given command in the help cache of a parser.
+ * @param parser The parser holding the commands
+ * @param command Name of the command or NULL for the root command
+ * @return 0 for the root command, the index of the command + 1 or SIZE_MAX if there is no such command
+ */
+size_t _cli_help_slot(const cli_parser *parser, char *command) {
+    if (command == NULL) {
+        return 0;
+    }
+    uint32_t cmd = _cli_find_command(parser, command);
+    return cmd != CLI_INDEX_END ? (size_t)cmd + 1 : SIZE_MAX;
+}
+
+/**
+ * @brief Returns the cached help menu of the given command and renders it on first use. Safe to call from multiple threads. If two threads render the same help menu at once the first one to finish is kept.
+ * @param parser The parser holding the help cache
+ * @param command The command to get the help menu of. Set to NULL for the root command
+ * @return The cached help menu or NULL if the parser has no help cache or the command does not exist
+ */
+const cli_help_text *_cli_parser_help_text(const cli_parser *parser, char *command) {
+    if (parser->help == NULL) {
+        return NULL;
+    }
+    size_t slot = _cli_help_slot(parser, command);
+    if (slot == SIZE_MAX) {
+        return NULL;
+    }
+    cli_help_text *help = __atomic_load_n(&parser->help[slot], __ATOMIC_ACQUIRE);
+    if (help != NULL) {
+        return help;
+    }
+
+    cli_buffer buf = {NULL, 0, 0};
+    cli_buffer splices = {NULL, 0, 0};
+    _cli_help_render(parser, command, NULL, &buf, &splices);
+    // The help text, its splices and the text are stored in a single block
+    help = (cli_help_text *)CLI_MALLOC(sizeof(cli_help_text) + splices.len + buf.len + 1);
+    cli_check_alloc(help);
+    help->splices = (size_t *)(help + 1);
+    help->splice_count = splices.len / sizeof(size_t);
+    help->text = (char *)help->splices + splices.len;
+    help->len = buf.len;
+    if (splices.len > 0) {
+        memcpy(help->splices, splices.data, splices.len);
+    }
+    memcpy(help->text, buf.data, buf.len + 1);
+    CLI_FREE(buf.data);
+    CLI_FREE(splices.data);
+
+    cli_help_text *expected = NULL;
+    if (!__atomic_compare_exchange_n(&parser->help[slot], &expected, help, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        CLI_FREE(help);
+        help = expected;
+    }
+    return help;
+}
+
+/**
+ * @brief Writes a cached help menu to stdout with the name of the binary spliced in. The pieces are written with a single writev call.
+ * @param help The cached help menu
+ * @param bin The name of the binary
+ */
+void _cli_help_text_write(const cli_help_text *help, const char *bin) {
+    struct iovec iov[64];
+    size_t bin_len = strlen(bin);
+    size_t pos = 0;
+    size_t splice = 0;
+    fflush(stdout);
+    while (pos < help->len || splice < help->splice_count) {
+        int count = 0;
+        while (count < 62 && (pos < help->len || splice < help->splice_count)) {
+            size_t end = splice < help->splice_count ? help->splices[splice] : help->len;
+            if (end > pos) {
+                iov[count].iov_base = help->text + pos;
+                iov[count].iov_len = end - pos;
+                count++;
+                pos = end;
+            }
+            if (splice < help->splice_count) {
+                iov[count].iov_base = (void *)bin;
+                iov[count].iov_len = bin_len;
+                count++;
+                splice++;
+            }
+        }
+        _cli_writev_stdout(iov, count);
+    }
+}
+
+/**
+ * @brief Appends a cached help menu to the buffer with the name of the binary spliced in.
+ * @param help The cached help menu
+ * @param bin The name of the binary
+ * @param buf The buffer to append to
+ */
+void _cli_help_text_splice(const cli_help_text *help, const char *bin, cli_buffer *buf) {
+    size_t pos = 0;
+    _cli_buf_reserve(buf, help->len + help->splice_count * strlen(bin));
+    for (size_t i = 0; i < help->splice_count; i++) {
+        _cli_buf_append(buf, help->text + pos, help->splices[i] - pos);
+        _cli_buf_puts(buf, bin);
+        pos = help->splices[i];
+    }
+    _cli_buf_append(buf, help->text + pos, help->len - pos);
+}
+
+/**
+ * @brief Prints the help menu. Compiled parsers serve it from their help cache.
+ * @param parser The parser holding the tables of the cli
+ * @param command The command to print the help menu of. Set to NULL to print help for the root command
+ * @param argv The argv array
+ */
+void _cli_help(const cli_parser *parser, char *command, char *argv[]) {
+    const cli_help_text *help = _cli_parser_help_text(parser, command);
+    if (help != NULL) {
+        _cli_help_text_write(help, argv[0]);
+        return;
+    }
+    cli_buffer buf = {NULL, 0, 0};
+    _cli_help_render(parser, command, argv[0], &buf, NULL);
+    _cli_write_stdout(buf.data, buf.len);
+    CLI_FREE(buf.data);
+}
+
+/**
+ * @brief Prints the help menu.
+ * @param commands All commands of the cli. Set to NULL if there are no commands else a zero-terminated array of @ref command_t
+ * @param command The command to print the help menu of. Set to NULL to print help for the root command
+ * @param options All options of the cli as a zero-terminated array of @ref option_t
+ * @param argv The argv array
+ * @param examples Optional zero-terminated array of examples
+ */
+void cli_help(cli_command *commands, char *command, cli_option *options, char *argv[], cli_example *examples) {
+    cli_parser parser;
+    _cli_parser_init(&parser, commands, options, NULL, examples);
+    _cli_help(&parser, command, argv);
+}
+
+/**
+ * @brief Prints the help menu of the given parser. The help menu of each command is rendered once and served from the cache of the parser afterwards.
+ * @param parser The parser to print the help menu of
+ * @param command The command to print the help menu of. Set to NULL to print help for the root command
+ * @param argv The argv array
+ */
+void cli_parser_help(const cli_parser *parser, char *command, char *argv[]) {
+    _cli_help(parser, command, argv);
+}
+
+/**
+ * @brief Renders the help menu of the given parser into a string instead of printing it.
+ * @param parser The parser to render the help menu of
+ * @param command The command to render the help menu of. Set to NULL to render help for the root command
+ * @param bin The name of the binary as shown in the usage, usually argv[0]
+ * @param len Optional pointer which receives the length of the rendered help menu
+ * @return The zero-terminated help menu. Must be freed with @ref cli_free
+ */
+char *cli_parser_help_render(const cli_parser *parser, char *command, const char *bin, size_t *len) {
+    cli_buffer buf = {NULL, 0, 0};
+    const cli_help_text *help = _cli_parser_help_text(parser, command);
+    if (help != NULL) {
+        _cli_help_text_splice(help, bin, &buf);
+    } else {
+        _cli_help_render(parser, command, bin, &buf, NULL);
+    }
+    if (len != NULL) {
+        *len = buf.len;
+    }
+    return buf.data;
+}
+
+/**
+ * @brief Renders the help menu into a string instead of printing it.
+ * @param commands All commands of the cli. Set to NULL if there are no commands else a zero-terminated array of @ref command_t
+ * @param command The command to render the help menu of. Set to NULL to render help for the root command
+ * @param options All options of the cli as a zero-terminated array of @ref option_t
+ * @param bin The name of the binary as shown in the usage, usually argv[0]
+ * @param examples Optional zero-terminated array of examples
+ * @param len Optional pointer which receives the length of the rendered help menu
+ * @return The zero-terminated help menu. Must be freed with @ref cli_free
+ */
+char *cli_help_render(cli_command *commands, char *command, cli_option *options, const char *bin, cli_example *examples, size_t *len) {
+    cli_parser parser;
+    _cli_parser_init(&parser, commands, options, NULL, examples);
+    return cli_parser_help_render(&parser, command, bin, len);
+}
+
+/**
+ * @brief Returns whether the given option is a long style option or not.
+ * @param opt The string of the option to check
+ * @return True if the option is a long option, false if not
+ */
+bool _cli_is_long_opt(char *opt) {
+    return opt[0] == '-' && opt[1] == '-' && opt[2] != 0;
+}
+
+/**
+ * @brief Determines the type of short option for the given string.
+ * @param opt The string of the option to check
+ * @return The type of the short option as described in @ref short_opt_type_t
+ */
+cli_short_opt_type _cli_short_opt_type(char *opt) {
+    if (opt[0] != '-' || opt[1] == 0) {
+        return none;
+    }
+
+    if (opt[2] != 0) {
+        return multiple;
+    }
+
+    return opt[1] != '-' ? single : none;
+}
+
+/**
+ * @brief Returns whether the given string is an option or not.
+ * @param opt The string if the option to check
+ * @return True if the string is an option, else false
+ * @note See @ref _short_opt_type and @ref _is_long_opt
+ */
+bool _cli_is_option(char *opt) {
+    return _cli_is_long_opt(opt) || _cli_short_opt_type(opt) != none;
+}
+
+/**
+ * @brief Finds the option with the given name in the context of the given command. The name does not have to be zero-terminated.
+ * @param index The index of the options
+ * @param options The indexed zero-terminated array of @ref option_t
+ * @param name The name of the option without the leading '--'
+ * @param len The length of the name
+ * @param cmd_idx The index of the command
+ * @return The index of the option or @ref CLI_INDEX_END if no option matches
+ */
+uint32_t _cli_index_find_long_n(const cli_index *index, cli_option *options, const char *name, size_t len, uint64_t cmd_idx) {
+    uint32_t hash = _cli_hash(name, len);
+    for (uint32_t i = index->buckets[hash & index->mask]; i != CLI_INDEX_END; i = index->long_next[i]) {
+        const char *long_arg = options[i].long_arg;
+        if (index->hashes[i] == hash && _cli_opt_in_cmd(index, i, cmd_idx) && strncmp(long_arg, name, len) == 0 && long_arg[len] == 0) {
+            return i;
+        }
+    }
+    return CLI_INDEX_END;
+}
+
+/**
+ * @brief Finds the options of the given command whose long name starts with the given prefix by binary search over the sorted names.
+ * @param index The index of the options
+ * @param options The indexed zero-terminated array of @ref option_t
+ * @param prefix The prefix without the leading '--'
+ * @param len The length of the prefix
+ * @param cmd_idx The index of the command
+ * @param other Receives a second matching option or @ref CLI_INDEX_END if the match is unique
+ * @return The index of the first matching option or @ref CLI_INDEX_END if no option matches
+ */
+uint32_t _cli_index_find_prefix(const cli_index *index, cli_option *options, const char *prefix, size_t len, uint64_t cmd_idx, uint32_t *other) {
+    size_t lo = 0;
+    size_t hi = index->opt_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strncmp(options[index->sorted[mid]].long_arg, prefix, len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    uint32_t found = CLI_INDEX_END;
+    *other = CLI_INDEX_END;
+    for (size_t i = lo; i < index->opt_count && strncmp(options[index->sorted[i]].long_arg, prefix, len) == 0; i++) {
+        uint32_t opt_idx = index->sorted[i];
+        if (!_cli_opt_in_cmd(index, opt_idx, cmd_idx)) {
+            continue;
+        }
+        if (found != CLI_INDEX_END) {
+            *other = opt_idx;
+            break;
+        }
+        found = opt_idx;
+    }
+    return found;
+}
+
+/**
+ * @brief Finds the option with the given short_arg in the context of the given command.
+ * @param index The index of the options
+ * @param short_arg The shorthand to look for
+ * @param cmd_idx The index of the command
+ * @return The index of the option or @ref CLI_INDEX_END if no option matches
+ */
+uint32_t _cli_index_find_short(const cli_index *index, char short_arg, uint64_t cmd_idx) {
+    for (uint32_t i = index->short_head[(unsigned char)short_arg]; i != CLI_INDEX_END; i = index->short_next[i]) {
+        if (_cli_opt_in_cmd(index, i, cmd_idx)) {
+            return i;
+        }
+    }
+    return CLI_INDEX_END;
+}
+
+/**
+ * @brief Checks if any required options in the context of the given command are not set. Fails on the first violation.
+ * @param parser The parser holding the options and the exclusions to know if two required options are mutually exclusive
+ * @param result The result of the current parse
+ * @param cmd_idx The index of the command
+ * @return False if a required option is missing, else true
+ */
+bool _cli_check_unmatched(const cli_parser *parser, cli_result *result, uint64_t cmd_idx) {
+    cli_exclusion *mutual_exclusions = parser->exclusions;
+    for (size_t req_idx = 0; req_idx < parser->index.req_count; req_idx++) {
+        uint32_t opt_idx = parser->index.required[req_idx];
+        cli_option opt = parser->options[opt_idx];
+        if (!_cli_opt_in_cmd(&parser->index, opt_idx, cmd_idx)) {
+            continue;
+        }
+        if (!_cli_is_matched(parser, result, opt_idx)) {
+            size_t idx = 0;
+            cli_exclusion ex;
+            bool can_proceed = false;
+            if (mutual_exclusions != NULL) {
+                while ((ex = mutual_exclusions[idx++]).one != NULL) {
+                    if (cli_streq(ex.one, opt.long_arg) || cli_streq(ex.other, opt.long_arg)) {
+                        can_proceed = true;
+                        break;
+                    }
+                }
+            }
+            if (can_proceed) {
+                continue;
+            }
+            return _cli_fail(result, cli_err_missing_required, -1, "Missing required argument `%s`", opt.long_arg);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Finds the help option among the given arguments.
+ * @param argc The argc value
+ * @param argv The argv array
+ * @return True if -h or --help appears before the first '--', else false
+ */
+bool _cli_find_help(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        char *arg = argv[i];
+        if (strcmp(arg, "--") == 0 || strcmp(arg, "-") == 0) {
+            return false;
+        }
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Collects the state of all options with the given name for a mutual exclusion check.
+ * @param parser The parser holding the options and their index
+ * @param result The result of the current parse
+ * @param name The name of the option
+ * @param cmd_idx The index of the command
+ * @param matched Set to whether the option is matched
+ * @param required Cleared if the option is not required
+ * @return False if an option with the given name is not relevant for the command, else true
+ */
+bool _cli_exclusion_side(const cli_parser *parser, const cli_result *result, const char *name, uint64_t cmd_idx, bool *matched, bool *required) {
+    const cli_index *index = &parser->index;
+    uint32_t hash = _cli_hash(name, strlen(name));
+    for (uint32_t i = index->buckets[hash & index->mask]; i != CLI_INDEX_END; i = index->long_next[i]) {
+        cli_option opt = parser->options[i];
+        if (index->hashes[i] != hash || !cli_streq(name, opt.long_arg)) {
+            continue;
+        }
+        if (!_cli_opt_in_cmd(index, i, cmd_idx)) {
+            return false;
+        }
+        *matched = _cli_is_matched(parser, result, i);
+        *required &= CLI_ARG_REQUIRED(opt.params);
+    }
+    return true;
+}
+
+/**
+ * @brief Checks if any mutual exclusions are violated. Fails on the first violation.
+ * @param parser The parser holding the options, their index and the exclusions
+ * @param result The result of the current parse
+ * @param cmd_idx The index of the command
+ * @return False if an exclusion is violated, else true
+ */
+bool _cli_check_mutual_exclusions(const cli_parser *parser, cli_result *result, uint64_t cmd_idx) {
+    if (parser->exclusions == NULL) {
+        return true;
+    }
+    size_t idx = 0;
+    cli_exclusion exclusion;
+    while ((exclusion = parser->exclusions[idx++]).one != NULL) {
+        if (exclusion.other == NULL) {
+            cli_panic("check_mutual_exclusions: NULL in non NULL exclusion!");
+        }
+        if (strlen(exclusion.one) == 0 || strlen(exclusion.other) == 0) {
+            cli_panic("check_mutual_exclusions: Empty exclusion!");
+        }
+        bool one_matched = false;
+        bool other_matched = false;
+        bool both_required = true;
+        if (!_cli_exclusion_side(parser, result, exclusion.one, cmd_idx, &one_matched, &both_required) ||
+            !_cli_exclusion_side(parser, result, exclusion.other, cmd_idx, &other_matched, &both_required)) {
+            continue;
+        }
+        if (one_matched == false && other_matched == false && both_required) {
+            return _cli_fail(result, cli_err_exclusion_required, -1, "One of the options `%s` and `%s` is required because they are both required but mutually exclusive", exclusion.one, exclusion.other);
+        }
+        if (one_matched == true && other_matched == true) {
+            return _cli_fail(result, cli_err_mutually_exclusive, -1, "Options `%s` and `%s` are mutually exclusive. Please provide only one of them", exclusion.one, exclusion.other);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns how many leading arguments the name of the given command spans. The words of a nested command are separated by single spaces in its name, so `tool cluster node` runs the command named "cluster node".
+ * @param name The name of the command
+ * @param argc The length of argv. Only arguments before it are compared
+ * @param argv The argv array
+ * @return The amount of arguments after argv[0] which make up exactly the name or 0 if they do not
+ */
+int _cli_command_path_len(const char *name, int argc, char *argv[]) {
+    for (int k = 1; k < argc; k++) {
+        const char *arg = argv[k];
+        while (*arg != 0 && *arg == *name) {
+            arg++;
+            name++;
+        }
+        if (*arg != 0) {
+            return 0;
+        }
+        if (*name == 0) {
+            return k;
+        }
+        if (*name != ' ') {
+            return 0;
+        }
+        name++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Checks for which command is being run. The deepest command named by the leading arguments wins. With a command index every level costs one lookup, so the cost depends on the depth of the command and not on the amount of commands. Adheres to the specification in @ref ARG_MAKE.
+ * @param parser The parser holding the commands
+ * @param argc The length of argv
+ * @param argv The argv array
+ * @param depth Set to the amount of arguments naming the command
+ * @returns A number <= 1 representing the command which is being run
+ */
+size_t _run_command(const cli_parser *parser, int argc, char *argv[], int *depth) {
+    const cli_command_index *index = &parser->cmd_index;
+    uint32_t cmd = CLI_INDEX_END;
+    *depth = 0;
+    if (index->buckets == NULL) {
+        for (size_t i = 0; i < parser->cmd_count; i++) {
+            int len = _cli_command_path_len(parser->commands[i].command, argc, argv);
+            if (len > *depth) {
+                *depth = len;
+                cmd = i;
+            }
+        }
+        return cmd != CLI_INDEX_END ? (size_t)cmd + 2 : 1;
+    }
+
+    uint32_t hash = _cli_hash(NULL, 0);
+    for (int k = 1; k < argc && (size_t)k <= index->max_depth; k++) {
+        if (k > 1) {
+            hash = _cli_hash_continue(hash, " ", 1);
+        }
+        hash = _cli_hash_continue(hash, argv[k], strlen(argv[k]));
+        for (uint32_t i = index->buckets[hash & index->mask]; i != CLI_INDEX_END; i = index->next[i]) {
+            if (index->hashes[i] == hash && _cli_command_path_len(parser->commands[i].command, k + 1, argv) == k) {
+                *depth = k;
+                cmd = i;
+                break;
+            }
+        }
+    }
+    return cmd != CLI_INDEX_END ? (size_t)cmd + 2 : 1;
+}
+
+/**
+ * @def CLI_ARENA_ALIGN
+ * @brief Alignment of all allocations handed out by a @ref cli_arena.
+ */
+#define CLI_ARENA_ALIGN 16
+
+/**
+ * @brief Initializes an empty arena. No memory is allocated until the first allocation.
+ * @param arena The arena to initialize
+ * @param block_size The minimum size of the blocks the arena allocates. 0 selects a default of 4096 bytes
+ */
+void cli_arena_init(cli_arena *arena, size_t block_size) {
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->block_size = block_size == 0 ? 4096 : block_size;
+}
+
+/**
+ * @brief Allocates memory from the arena. The memory is aligned to @ref CLI_ARENA_ALIGN and valid until the arena is reset or freed.
+ * @param arena The arena to allocate from
+ * @param size The amount of bytes to allocate
+ * @return The allocated memory
+ */
+void *cli_arena_alloc(cli_arena *arena, size_t size) {
+    // The header of a block is padded so the data of the block keeps the alignment
+    size_t header = (sizeof(cli_arena_block) + CLI_ARENA_ALIGN - 1) & ~(size_t)(CLI_ARENA_ALIGN - 1);
+    size = (size + CLI_ARENA_ALIGN - 1) & ~(size_t)(CLI_ARENA_ALIGN - 1);
+    cli_arena_block *block = arena->current;
+    while (block != NULL && block->cap - block->used < size) {
+        block = block->next;
+        if (block != NULL) {
+            block->used = 0;
+        }
+    }
+    if (block == NULL) {
+        size_t cap = size > arena->block_size ? size : arena->block_size;
+        block = (cli_arena_block *)CLI_MALLOC(header + cap);
+        cli_check_alloc(block);
+        block->cap = cap;
+        block->used = 0;
+        block->next = NULL;
+        if (arena->current != NULL) {
+            // Blocks skipped above are too small for this allocation but stay in the arena for later ones
+            cli_arena_block *last = arena->current;
+            while (last->next != NULL) {
+                last = last->next;
+            }
+            last->next = block;
+        } else {
+            arena->head = block;
+        }
+    }
+    arena->current = block;
+    void *ptr = (char *)block + header + block->used;
+    block->used += size;
+    return ptr;
+}
+
+/**
+ * @brief Releases everything allocated from the arena at once. The blocks are kept and reused by later allocations.
+ * @param arena The arena to reset
+ */
+void cli_arena_reset(cli_arena *arena) {
+    arena->current = arena->head;
+    if (arena->head != NULL) {
+        arena->head->used = 0;
+    }
+}
+
+/**
+ * @brief Releases the arena together with all of its blocks.
+ * @param arena The arena to release
+ */
+void cli_arena_free(cli_arena *arena) {
+    cli_arena_block *block = arena->head;
+    while (block != NULL) {
+        cli_arena_block *next = block->next;
+        CLI_FREE(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+}
+
+/**
+ * @brief Allocates memory for the current parse. The memory comes from the arena of the result if one is set.
+ * @param result The result of the current parse
+ * @param size The amount of bytes to allocate
+ * @return The allocated memory
+ */
+void *_cli_alloc(cli_result *result, size_t size) {
+    if (result->arena != NULL) {
+        return cli_arena_alloc(result->arena, size);
+    }
+    void *ptr = CLI_MALLOC(size);
+    cli_check_alloc(ptr);
+    return ptr;
+}
+
+/**
+ * @brief Releases memory allocated with @ref _cli_alloc. Memory from an arena is only released with the arena.
+ * @param result The result of the current parse
+ * @param ptr The memory to release
+ */
+void _cli_release(cli_result *result, void *ptr) {
+    if (result->arena == NULL) {
+        CLI_FREE(ptr);
+    }
+}
+
+/**
+ * @brief Makes sure that the given array can hold at least one more item.
+ * @param arena Optional arena to allocate the grown array from. The old array is left in the arena
+ * @param items The array to grow
+ * @param cap The capacity of the array
+ * @param len The amount of items in the array
+ * @param size The size of a single item
+ */
+void _cli_grow(cli_arena *arena, void **items, size_t *cap, size_t len, size_t size) {
+    if (len < *cap) {
+        return;
+    }
+    size_t new_cap = *cap == 0 ? 16 : *cap * 2;
+    if (arena != NULL) {
+        void *grown = cli_arena_alloc(arena, new_cap * size);
+        if (len > 0) {
+            memcpy(grown, *items, len * size);
+        }
+        *items = grown;
+    } else {
+        *items = CLI_REALLOC(*items, new_cap * size);
+        cli_check_alloc(*items);
+    }
+    *cap = new_cap;
+}
+
+/**
+ * @brief Appends a value to a list. The values of the list are discarded first if requested, keeping the array if it is owned by the list.
+ * @param list The list to append to
+ * @param reset Whether to discard the current values of the list, e.g. its default values
+ * @param value The value to append
+ * @param arena Optional arena to allocate the array from. Arrays from an arena are not owned by the list, so their capacity is derived from the length instead of being stored
+ */
+void _cli_list_append(cli_list *list, bool reset, char *value, cli_arena *arena) {
+    if (reset) {
+        if (list->cap == 0) {
+            list->items = NULL;
+        }
+        list->len = 0;
+    }
+    if (arena != NULL && list->cap == 0) {
+        // Arrays from the arena grow by doubling from 16, so the capacity follows from the length
+        size_t cap = list->len == 0 ? 0 : 16;
+        while (cap != 0 && cap < list->len) {
+            cap *= 2;
+        }
+        _cli_grow(arena, (void **)&list->items, &cap, list->len, sizeof(char *));
+    } else {
+        _cli_grow(NULL, (void **)&list->items, &list->cap, list->len, sizeof(char *));
+    }
+    list->items[list->len++] = value;
+}
+
+/**
+ * @brief Releases the array of a list filled by the parser. Lists whose array is not owned, e.g. static defaults or arrays from an arena, are only emptied.
+ * @param list The list to release
+ */
+void cli_list_free(cli_list *list) {
+    if (list->cap > 0) {
+        CLI_FREE(list->items);
+    }
+    list->items = NULL;
+    list->len = 0;
+    list->cap = 0;
+}
+
+/**
+ * @brief Converts the value given to a non-boolean option according to the type of the option.
+ * @param parser The parser holding the options
+ * @param result The result of the current parse receiving the error
+ * @param argv_idx The index of the argument holding the value in argv or -1
+ * @param opt_idx The index of the option
+ * @param value The value given to the option
+ * @param data Receives the converted value. For list options the value is stored as the item in str_data
+ * @return False if the value is not a valid number, else true
+ */
+bool _cli_convert_value(const cli_parser *parser, cli_result *result, int argv_idx, uint32_t opt_idx, char *value, cli_data *data) {
+    cli_option opt = parser->options[opt_idx];
+    if (CLI_ARG_TYPE(opt.params) == list || CLI_ARG_TYPE(opt.params) == string) {
+        data->str_data = value;
+    } else if (CLI_ARG_TYPE(opt.params) == number) {
+        if (!cli_try_parse_int(value, &data->num_data)) {
+            return _cli_fail(result, cli_err_invalid_number, argv_idx, "Invalid numerical sequence for option `%s`: %s", opt.long_arg, value);
+        }
+    } else if (CLI_ARG_TYPE(opt.params) == unumber) {
+        if (!cli_try_parse_uint(value, &data->unum_data)) {
+            return _cli_fail(result, cli_err_invalid_number, argv_idx, "Invalid numerical sequence for option `%s`: %s", opt.long_arg, value);
+        }
+    } else {
+        cli_panic("Unrecognized type of flag encountered!");
+    }
+    return true;
+}
+
+/**
+ * @brief Stores a converted value in an option. List options append the item in str_data.
+ * @param parser The parser holding the options
+ * @param result The result of the current parse
+ * @param opt_idx The index of the option
+ * @param data The converted value
+ * @param first Whether this is the first value of the option in the current parse, which resets a list
+ */
+void _cli_store_value(const cli_parser *parser, cli_result *result, uint32_t opt_idx, const cli_data *data, bool first) {
+    cli_data *value = _cli_value(parser, result, opt_idx);
+    if (CLI_ARG_TYPE(parser->options[opt_idx].params) == list) {
+        _cli_list_append(&value->list_data, first, data->str_data, result->arena);
+    } else {
+        *value = *data;
+    }
+}
+
+/**
+ * @brief Marks an option as matched and stores the given value in it. List options collect all values given in the same parse.
+ * @param parser The parser holding the options
+ * @param result The result of the current parse
+ * @param argv_idx The index of the argument holding the value in argv
+ * @param opt_idx The index of the option
+ * @param value The value given to the option
+ * @return False if the value is not a valid number, else true
+ */
+bool _cli_parse_value(const cli_parser *parser, cli_result *result, int argv_idx, uint32_t opt_idx, char *value) {
+    cli_data data;
+    if (!_cli_convert_value(parser, result, argv_idx, opt_idx, value, &data)) {
+        return false;
+    }
+    bool first = !_cli_is_matched(parser, result, opt_idx);
+    _cli_set_matched(parser, result, opt_idx);
+    _cli_store_value(parser, result, opt_idx, &data, first);
+    return true;
+}
+
+/**
+ * @brief Appends a value to a layer.
+ * @param arena Optional arena to allocate the grown entries from
+ * @param layer The layer
+ * @param opt_idx The index of the option
+ * @param value The value
+ */
+void _cli_layer_push(cli_arena *arena, cli_layer *layer, uint32_t opt_idx, cli_data value) {
+    _cli_grow(arena, (void **)&layer->entries, &layer->cap, layer->len, sizeof(cli_layer_entry));
+    layer->entries[layer->len].opt_idx = opt_idx;
+    layer->entries[layer->len].value = value;
+    layer->len++;
+}
+
+/**
+ * @brief Adds the value of an option to a layer. Adding a list option again adds another item, adding any other option again replaces its value when the layers are merged.
+ * @param layer The layer
+ * @param opt_idx The index of the option
+ * @param value The value. For list options a single item in str_data
+ */
+void cli_layer_add(cli_layer *layer, uint32_t opt_idx, cli_data value) {
+    _cli_layer_push(NULL, layer, opt_idx, value);
+}
+
+/**
+ * @brief Releases the entries of a layer. The strings in the values are not released.
+ * @param layer The layer
+ */
+void cli_layer_free(cli_layer *layer) {
+    CLI_FREE(layer->entries);
+    layer->entries = NULL;
+    layer->len = 0;
+    layer->cap = 0;
+}
+
+/**
+ * @brief Parses a cluster of short options like -abc or -ovalue in a single pass. Boolean options are set until the first option which takes a value. The rest of the cluster is the value of that option.
+ * @param parser The parser holding the options and their index
+ * @param result The result of the current parse
+ * @param argv_idx The index of the cluster in argv
+ * @param arg The cluster including the leading dash
+ * @param cmd_idx The index of the command
+ * @param pending Receives the index of the last option of the cluster if it takes a value which is not attached to the cluster, else @ref CLI_INDEX_END
+ * @return False if the cluster contains an unknown option or an invalid value, else true
+ */
+bool _cli_parse_short_cluster(const cli_parser *parser, cli_result *result, int argv_idx, char *arg, uint64_t cmd_idx, uint32_t *pending) {
+    *pending = CLI_INDEX_END;
+    for (size_t i = 1; arg[i] != 0; i++) {
+        uint32_t opt_idx = _cli_index_find_short(&parser->index, arg[i], cmd_idx);
+        if (opt_idx == CLI_INDEX_END) {
+            return _cli_fail(result, cli_err_unknown_argument, argv_idx, "Unknown argument `-%c` in `%s`", arg[i], arg);
+        }
+        if (CLI_ARG_TYPE(parser->options[opt_idx].params) == boolean) {
+            _cli_set_matched(parser, result, opt_idx);
+            _cli_value(parser, result, opt_idx)->bool_data = true;
+            continue;
+        }
+        if (arg[i + 1] == 0) {
+            *pending = opt_idx;
+            return true;
+        }
+        return _cli_parse_value(parser, result, argv_idx, opt_idx, arg + i + 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Assigns a positional argument to the next positional option of the command. Positional options are filled in declaration order. A positional list takes all remaining positional arguments.
+ * @param parser The parser holding the options and their index
+ * @param result The result of the current parse
+ * @param argv_idx The index of the argument in argv
+ * @param cmd_idx The index of the command
+ * @param arg The positional argument
+ * @param cursor Position in the positional options of the index at which the search for the next positional option starts. Advanced past every filled option
+ * @return False if there is no positional option left to take the argument, else true
+ */
+bool _cli_parse_positional(const cli_parser *parser, cli_result *result, int argv_idx, uint64_t cmd_idx, char *arg, size_t *cursor) {
+    const cli_index *index = &parser->index;
+    for (; *cursor < index->pos_count; (*cursor)++) {
+        uint32_t opt_idx = index->positionals[*cursor];
+        cli_option opt = parser->options[opt_idx];
+        if (!_cli_opt_in_cmd(index, opt_idx, cmd_idx)) {
+            continue;
+        }
+        if (CLI_ARG_TYPE(opt.params) == list) {
+            return _cli_parse_value(parser, result, argv_idx, opt_idx, arg);
+        }
+        _cli_set_matched(parser, result, opt_idx);
+        _cli_value(parser, result, opt_idx)->str_data = arg;
+        (*cursor)++;
+        return true;
+    }
+
+    size_t pos_arg_count = 0;
+    for (size_t pos_idx = 0; pos_idx < index->pos_count; pos_idx++) {
+        pos_arg_count += _cli_opt_in_cmd(index, index->positionals[pos_idx], cmd_idx);
+    }
+    return _cli_fail(result, cli_err_too_many_positionals, argv_idx, "Too many positional arguments: Expected %lu, unexpected `%s`", pos_arg_count, arg);
+}
+
+/**
+ * @brief Parses all the remaining values in argv as positional options.
+ * @param parser The parser holding the options and their index
+ * @param result The result of the current parse
+ * @param cmd_idx The index of the command
+ * @param argc_idx The index to start the parsing from
+ * @param argc The total length of argv
+ * @param argv The argv array
+ * @param cursor See @ref _cli_parse_positional
+ * @return False if there are more positional arguments than positional options, else true
+ */
+bool _cli_parse_remaining_positionals(const cli_parser *parser, cli_result *result, uint64_t cmd_idx, int argc_idx, int argc, char **argv, size_t *cursor) {
+    for (; argc_idx < argc; argc_idx++) {
+        char *arg = argv[argc_idx];
+        if (strcmp(arg, "--") == 0 || strcmp(arg, "-") == 0) {
+            continue;
+        }
+        if (!_cli_parse_positional(parser, result, argc_idx, cmd_idx, arg, cursor)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Resolves the name of a long option. An exact match always wins. If the parser allows abbreviations a unique prefix of a long name matches as well.
+ * @param parser The parser holding the options and their index
+ * @param result The result of the current parse
+ * @param argv_idx The index of the argument in argv
+ * @param name The name without the leading '--'
+ * @param len The length of the name
+ * @param cmd_idx The index of the command
+ * @param opt_idx Receives the index of the option or @ref CLI_INDEX_END if no option matches
+ * @return False if the abbreviation is ambiguous, else true
+ */
+bool _cli_find_long_arg(const cli_parser *parser, cli_result *result, int argv_idx, const char *name, size_t len, uint64_t cmd_idx, uint32_t *opt_idx) {
+    *opt_idx = _cli_index_find_long_n(&parser->index, parser->options, name, len, cmd_idx);
+    if (*opt_idx != CLI_INDEX_END || !parser->abbreviations || len == 0) {
+        return true;
+    }
+    uint32_t other;
+    *opt_idx = _cli_index_find_prefix(&parser->index, parser->options, name, len, cmd_idx, &other);
+    if (other != CLI_INDEX_END) {
+        return _cli_fail(result, cli_err_ambiguous_argument, argv_idx, "Ambiguous argument `--%.*s`. It could be `%s` or `%s`", (int)len, name, parser->options[*opt_idx].long_arg, parser->options[other].long_arg);
+    }
+    return true;
+}
+
+/**
+ * @brief Parses an option of type --opt=arg or -o=arg. The name and the value are sliced out of the argument in place, nothing is copied.
+ * @param parser The parser holding the options and their index
+ * @param result The result of the current parse
+ * @param argv_idx The index of the argument in argv
+ * @param arg The string argument passed down to the cli
+ * @param eq_idx The index of the first '=' in the argument
+ * @param cmd_idx The index of the command
+ * @return False if the option is unknown or its value is invalid, else true
+ */
+bool _cli_parse_equals(const cli_parser *parser, cli_result *result, int argv_idx, char *arg, size_t eq_idx, uint64_t cmd_idx) {
+    cli_option *options = parser->options;
+    uint32_t opt_idx = CLI_INDEX_END;
+    if (arg[1] == '-') {
+        if (!_cli_find_long_arg(parser, result, argv_idx, arg + 2, eq_idx - 2, cmd_idx, &opt_idx)) {
+            return false;
+        }
+    } else if (eq_idx == 2) {
+        opt_idx = _cli_index_find_short(&parser->index, arg[1], cmd_idx);
+    }
+    if (opt_idx == CLI_INDEX_END) {
+        return _cli_fail(result, cli_err_unknown_argument, argv_idx, "Unknown argument `%s`", arg);
+    }
+
+    cli_option opt = options[opt_idx];
+    if (CLI_ARG_TYPE(opt.params) == boolean) {
+        return _cli_fail(result, cli_err_unexpected_argument, argv_idx, "Invalid flag usage. Option `%s` does not expect an argument", opt.long_arg);
+    }
+    return _cli_parse_value(parser, result, argv_idx, opt_idx, arg + eq_idx + 1);
+}
+
+/**
+ * @brief Returns whether a boolean option is enabled by the given value read from the environment or the config file.
+ * @param value The value
+ * @return False if the value is empty, 0, false, no or off, else true
+ */
+bool _cli_is_truthy(const char *value) {
+    return value[0] != 0 && !cli_streq(value, "0") && !cli_streq(value, "false") && !cli_streq(value, "no") && !cli_streq(value, "off");
+}
+
+/**
+ * @def CLI_ENV_NAME_MAX
+ * @brief Longest name of an environment variable after the prefix that is matched against the options. Longer variables are ignored.
+ */
+#ifndef CLI_ENV_NAME_MAX
+#define CLI_ENV_NAME_MAX 128
+#endif
+
+/**
+ * @brief Finds the option bound to the environment variable with the given name. The name is lowercased and underscores become dashes, so LOG_LEVEL binds `log-level`. If no option matches the underscores are kept.
+ * @param parser The parser holding the options and their index
+ * @param name The name of the variable after the prefix
+ * @param len The length of the name
+ * @param cmd_idx The index of the command
+ * @return The index of the option or @ref CLI_INDEX_END if no option matches
+ */
+uint32_t _cli_env_find(const cli_parser *parser, const char *name, size_t len, uint64_t cmd_idx) {
+    char long_arg[CLI_ENV_NAME_MAX] = {0};
+    if (len == 0 || len > sizeof(long_arg)) {
+        return CLI_INDEX_END;
+    }
+    bool underscores = false;
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        underscores |= c == '_';
+        long_arg[i] = c == '_' ? '-' : (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+    }
+    uint32_t opt_idx = _cli_index_find_long_n(&parser->index, parser->options, long_arg, len, cmd_idx);
+    if (opt_idx == CLI_INDEX_END && underscores) {
+        for (size_t i = 0; i < len; i++) {
+            if (name[i] == '_') {
+                long_arg[i] = '_';
+            }
+        }
+        opt_idx = _cli_index_find_long_n(&parser->index, parser->options, long_arg, len, cmd_idx);
+    }
+    return opt_idx;
+}
+
+/**
+ * @brief Collects the environment variables bound to the options of the command in a single pass over environ. Boolean options are set unless the value is empty, 0, false, no or off.
+ * @param parser The parser holding the options, their index and the prefix of the variables
+ * @param result The result of the current parse
+ * @param cmd_idx The index of the command
+ * @param layer Receives the converted values
+ * @return False if a variable holds an invalid value, else true
+ */
+bool _cli_parse_env(const cli_parser *parser, cli_result *result, uint64_t cmd_idx, cli_layer *layer) {
+    if (parser->env_prefix == NULL || environ == NULL) {
+        return true;
+    }
+    size_t prefix_len = parser->env_prefix_len;
+    for (char **env = environ; *env != NULL; env++) {
+        char *var = *env;
+        if (strncmp(var, parser->env_prefix, prefix_len) != 0 || var[prefix_len] != '_') {
+            continue;
+        }
+        char *name = var + prefix_len + 1;
+        char *eq = strchr(name, '=');
+        if (eq == NULL) {
+            continue;
+        }
+        uint32_t opt_idx = _cli_env_find(parser, name, (size_t)(eq - name), cmd_idx);
+        if (opt_idx == CLI_INDEX_END || CLI_ARG_POSITIONAL(parser->options[opt_idx].params)) {
+            continue;
+        }
+        char *value = eq + 1;
+        cli_data data;
+        if (CLI_ARG_TYPE(parser->options[opt_idx].params) == boolean) {
+            data.bool_data = _cli_is_truthy(value);
+        } else if (!_cli_convert_value(parser, result, -1, opt_idx, value, &data)) {
+            return _cli_fail(result, result->error.status, -1, "Invalid value for option `%s` in environment variable `%.*s`: %s", parser->options[opt_idx].long_arg, (int)(eq - var), var, value);
+        }
+        _cli_layer_push(result->arena, layer, opt_idx, data);
+    }
+    return true;
+}
+
+/**
+ * @brief Validates the given tables and builds everything the parser needs. All work that does not depend on argv happens here.
+ * @param parser The parser to set up
+ * @param commands All commands of the cli. Set to NULL if there are no commands else a zero-terminated array of @ref command_t
+ * @param options All options of the cli as a zero-terminated array of @ref option_t
+ * @param exclusions Optional zero-terminated array of @ref exclusion_t to respect
+ * @param examples Optional zero-terminated array of examples
+ * @param storage Optional storage for the index holding storage_len entries. The index is allocated if the options do not fit
+ * @param storage_len The amount of entries of the storage
+ */
+void _cli_parser_setup(cli_parser *parser, cli_command *commands, cli_option *options, cli_exclusion *exclusions, cli_example *examples, uint32_t *storage, size_t storage_len) {
+    _cli_parser_init(parser, commands, options, exclusions, examples);
+    _cli_validate_options(parser);
+    if (storage != NULL && CLI_INDEX_STORAGE(parser->opt_count) <= storage_len) {
+        _cli_index_build_into(&parser->index, options, parser->opt_count, storage);
+    } else {
+        _cli_index_build(&parser->index, options, parser->opt_count);
+    }
+}
+
+/**
+ * @brief Initializes a parser from tables whose lengths are known at compile time, e.g. tables defined with @ref CLI_OPTIONS. Nothing is allocated and the tables are not scanned for their terminators. The index is built into the given storage.
+ * @param parser The parser to initialize. It is not released with @ref cli_parser_free and has no help cache
+ * @param commands The zero-terminated array of @ref command_t or NULL
+ * @param cmd_count The amount of commands
+ * @param cmd_index_storage Optional storage for the command index holding at least @ref CLI_COMMAND_INDEX_STORAGE(cmd_count) entries. Has to outlive the parser. If NULL the commands are scanned
+ * @param options The zero-terminated array of @ref option_t
+ * @param opt_count The amount of options
+ * @param index_storage Storage for the index holding at least @ref CLI_INDEX_STORAGE(opt_count) entries. Has to outlive the parser
+ * @param exclusions Optional zero-terminated array of @ref exclusion_t to respect
+ * @param examples Optional zero-terminated array of examples
+ */
+void cli_parser_init_static(cli_parser *parser, cli_command *commands, size_t cmd_count, uint32_t *cmd_index_storage, cli_option *options, size_t opt_count, uint32_t *index_storage, cli_exclusion *exclusions, cli_example *examples) {
+    parser->commands = commands;
+    parser->options = options;
+    parser->exclusions = exclusions;
+    parser->examples = examples;
+    parser->cmd_count = cmd_count;
+    parser->opt_count = opt_count;
+    parser->env_prefix = NULL;
+    parser->env_prefix_len = 0;
+    parser->config_path = NULL;
+    parser->snapshot_path = NULL;
+    parser->layers = NULL;
+    parser->layer_count = 0;
+    parser->abbreviations = false;
+    parser->help = NULL;
+    _cli_validate_options(parser);
+    _cli_index_build_into(&parser->index, options, opt_count, index_storage);
+    memset(&parser->cmd_index, 0, sizeof(parser->cmd_index));
+    if (cmd_index_storage != NULL) {
+        _cli_command_index_build_into(&parser->cmd_index, commands, cmd_count, cmd_index_storage);
+    }
+}
+
+/**
+ * @brief Compiles the tables of a cli into a reusable parser. The tables are validated and indexed once, so every following call to @ref cli_parser_parse only has to walk argv.
+ * @param commands All commands of the cli. Set to NULL if there are no commands else a zero-terminated array of @ref command_t
+ * @param options All options of the cli as a zero-terminated array of @ref option_t
+ * @param exclusions Optional zero-terminated array of @ref exclusion_t to respect
+ * @param examples Optional zero-terminated array of examples
+ * @return The compiled parser. Release it with @ref cli_parser_free
+ * @note The tables are referenced, not copied. They have to outlive the parser
+ */
+cli_parser *cli_parser_compile(cli_command *commands, cli_option *options, cli_exclusion *exclusions, cli_example *examples) {
+    cli_parser *parser = (cli_parser *)CLI_MALLOC(sizeof(cli_parser));
+    cli_check_alloc(parser);
+    _cli_parser_setup(parser, commands, options, exclusions, examples, NULL, 0);
+    uint32_t *cmd_block = (uint32_t *)CLI_MALLOC(sizeof(uint32_t) * (_cli_index_bucket_count(parser->cmd_count) + parser->cmd_count * 2));
+    cli_check_alloc(cmd_block);
+    _cli_command_index_build_into(&parser->cmd_index, commands, parser->cmd_count, cmd_block);
+    parser->help = (cli_help_text **)CLI_MALLOC(sizeof(cli_help_text *) * (parser->cmd_count + 1));
+    cli_check_alloc(parser->help);
+    memset(parser->help, 0, sizeof(cli_help_text *) * (parser->cmd_count + 1));
+    return parser;
+}
+
+/**
+ * @brief Binds the options to environment variables named after the given prefix and the long name of the option, e.g. PREFIX_LOG_LEVEL for `log-level`. The environment is read in a single pass after argv and only fills options of the invoked command which are not given in argv. Options set from the environment count as given, also for required options.
+ * @param parser The parser to bind
+ * @param prefix The prefix without the trailing underscore or NULL to stop reading the environment. Has to outlive the parser
+ * @note Values of the options point into the environment. They stay valid as long as the variables are not changed
+ */
+void cli_parser_set_env_prefix(cli_parser *parser, const char *prefix) {
+    parser->env_prefix = prefix;
+    parser->env_prefix_len = prefix != NULL ? strlen(prefix) : 0;
+}
+
+/**
+ * @brief Reads the options from a config file beneath argv. Every line holds `long-arg = value`, a `[command]` header starts the options of that command and lines starting with # or ; are comments. Options before the first header belong to the root command. Global options may appear there for every command.
+ * @param parser The parser to read the config file with
+ * @param path The path of the config file or NULL to stop reading one. Has to outlive the parser. A missing file is ignored
+ * @note The file is read on every parse after argv and the environment and only fills options which neither of them set. Values of the options point into the file, release it with @ref cli_result_free once they are no longer needed
+ */
+void cli_parser_set_config_file(cli_parser *parser, const char *path) {
+    parser->config_path = path;
+}
+
+/**
+ * @brief Caches the resolved values of successful parses in a binary snapshot file. A later parse with the same tables, arguments, environment variables, response files and config file maps the snapshot and restores the values from it instead of parsing.
+ * @param parser The parser to cache the parses of
+ * @param path The path of the snapshot or NULL to stop using one. Has to outlive the parser. The file is replaced whenever a parse misses it
+ * @note Files are considered unchanged if their size, inode and modification and change times are. Values restored from the snapshot point into it, release it with @ref cli_result_free once they are no longer needed
+ */
+void cli_parser_set_snapshot(cli_parser *parser, const char *path) {
+    parser->snapshot_path = path;
+}
+
+/**
+ * @def CLI_SOURCE_APPLIED
+ * @brief Marks the source of an option once the first value of its winning layer is stored during a merge.
+ */
+#define CLI_SOURCE_APPLIED 0x80
+
+/**
+ * @brief Returns whether a layer ranks beneath argv, i.e. above @ref cli_source_none and below @ref cli_source_argv.
+ * @param layer The layer
+ * @return True if the layer may be merged, else false
+ */
+bool _cli_layer_ranked(const cli_layer *layer) {
+    return layer->source > cli_source_none && layer->source < cli_source_argv;
+}
+
+/**
+ * @brief Stacks additional sources beneath argv, e.g. defaults or a second config file. Every option takes its value from the source with the highest rank that sets it, see @ref cli_source. The values are merged in a single pass over the options after argv, the environment and the config file are read.
+ * @param parser The parser to stack the layers on
+ * @param layers The layers or NULL. Have to outlive the parser and may be changed between parses
+ * @param layer_count The amount of layers
+ * @return @ref cli_ok, or @ref cli_err_invalid_layer if a layer does not rank above @ref cli_source_none and below @ref cli_source_argv. The layers of the parser are left unchanged then
+ * @note Layers whose rank is changed to an invalid one later are skipped by the merge, so argv always wins
+ */
+cli_status cli_parser_set_layers(cli_parser *parser, const cli_layer *layers, size_t layer_count) {
+    for (size_t i = 0; i < layer_count; i++) {
+        if (!_cli_layer_ranked(&layers[i])) {
+            return cli_err_invalid_layer;
+        }
+    }
+    parser->layers = layers;
+    parser->layer_count = layer_count;
+    return cli_ok;
+}
+
+/**
+ * @brief Lets long options be abbreviated to any unique prefix of their name within the invoked command, e.g. --verb for --verbose. An exact name always wins over abbreviations. A prefix of more than one option fails with @ref cli_err_ambiguous_argument.
+ * @param parser The parser created with @ref cli_parser_compile or @ref cli_parser_init_static
+ * @param allow Whether abbreviations are accepted
+ * @note The first call allowing abbreviations sorts the long names into the reserved room of the index, so parsers that never allow them never pay for the sort
+ */
+void cli_parser_allow_abbreviations(cli_parser *parser, bool allow) {
+    cli_index *index = &parser->index;
+    if (allow && index->sorted == NULL) {
+        index->sorted = index->cmds + index->opt_count;
+        for (size_t i = 0; i < index->opt_count; i++) {
+            index->sorted[i] = (uint32_t)i;
+        }
+        _cli_index_sort(index->sorted, index->opt_count, parser->options);
+    }
+    parser->abbreviations = allow;
+}
+
+/**
+ * @brief Releases a parser created with @ref cli_parser_compile.
+ * @param parser The parser to release
+ */
+void cli_parser_free(cli_parser *parser) {
+    if (parser == NULL) {
+        return;
+    }
+    cli_index_free(&parser->index);
+    CLI_FREE(parser->cmd_index.buckets);
+    if (parser->help != NULL) {
+        for (size_t i = 0; i <= parser->cmd_count; i++) {
+            CLI_FREE(parser->help[i]);
+        }
+        CLI_FREE(parser->help);
+    }
+    CLI_FREE(parser);
+}
+
+/**
+ * @brief Fills a values array for @ref cli_result with the current values of the data fields of the options. Use it to start a parse from the defaults assigned in the options.
+ * @param parser The parser holding the options
+ * @param values Array with one entry per option of the parser
+ */
+void cli_parser_defaults(const cli_parser *parser, cli_data *values) {
+    for (size_t i = 0; i < parser->opt_count; i++) {
+        if (parser->options[i].data != NULL) {
+            values[i] = *parser->options[i].data;
+            if (CLI_ARG_TYPE(parser->options[i].params) == list) {
+                // The array stays with the option, the values only borrow it until the first value is parsed
+                values[i].list_data.cap = 0;
+            }
+        } else {
+            memset(&values[i], 0, sizeof(cli_data));
+        }
+    }
+}
+
+/**
+ * @brief Appends an argument to the argv of the result. The array is kept NULL-terminated.
+ * @param result The result holding the argv
+ * @param cap The capacity of the argv
+ * @param arg The argument to append
+ */
+void _cli_push_arg(cli_result *result, size_t *cap, char *arg) {
+    _cli_grow(result->arena, (void **)&result->argv, cap, (size_t)result->argc + 1, sizeof(char *));
+    result->argv[result->argc++] = arg;
+    result->argv[result->argc] = NULL;
+}
+
+/**
+ * @brief Returns whether the given character separates arguments in a response file or surrounds values in the config file.
+ * @param c The character to check
+ * @return True for spaces, tabs and line breaks, else false
+ */
+bool _cli_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Reads the contents of a response file or the config file. The file is memory-mapped privately so it can be tokenized in place. Files whose size is a multiple of the page size are read into memory instead, because the terminator of the last token would not fit into the mapping.
+ * @param result The result of the current parse
+ * @param path The path of the file
+ * @param file The file to fill
+ * @return False if the file could not be read, else true. errno describes the error
+ */
+bool _cli_read_file(cli_result *result, const char *path, cli_response_file *file) {
+    memset(file, 0, sizeof(cli_response_file));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (size == 0) {
+        close(fd);
+        return true;
+    }
+    if (page_size > 0 && size % (size_t)page_size != 0) {
+        void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        file->data = (char *)data;
+        file->len = size;
+        file->mapped = true;
+        return true;
+    }
+
+    file->data = (char *)_cli_alloc(result, size + 1);
+    file->len = size;
+    size_t done = 0;
+    while (done < size) {
+        ssize_t got = read(fd, file->data + done, size - done);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            int err = got < 0 ? errno : EIO;
+            close(fd);
+            _cli_release(result, file->data);
+            file->data = NULL;
+            errno = err;
+            return false;
+        }
+        done += (size_t)got;
+    }
+    close(fd);
+    return true;
+}
+
+#ifndef CCLI_NO_RESPONSE_FILES
+/**
+ * @brief Splits the contents of a response file into arguments in place and appends them to the argv of the result. Arguments are separated by whitespace. Single quotes keep everything literally, inside double quotes a backslash escapes `"` and `\`, outside of quotes a backslash escapes any character.
+ * @param file The response file to tokenize. Its contents are modified
+ * @param result The result holding the argv
+ * @param cap The capacity of the argv
+ * @return False if the file ends inside a quote, else true
+ */
+bool _cli_tokenize_response_file(cli_response_file *file, cli_result *result, size_t *cap) {
+    char *in = file->data;
+    char *end = file->data + file->len;
+    while (in < end) {
+        if (_cli_is_space(*in)) {
+            in++;
+            continue;
+        }
+        char *arg = in;
+        char *out = in;
+        char quote = 0;
+        while (in < end) {
+            char c = *in;
+            if (quote != 0) {
+                if (c == quote) {
+                    quote = 0;
+                    in++;
+                    continue;
+                }
+                if (quote == '"' && c == '\\' && in + 1 < end && (in[1] == '"' || in[1] == '\\')) {
+                    c = *(++in);
+                }
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+                in++;
+                continue;
+            } else if (_cli_is_space(c)) {
+                break;
+            } else if (c == '\\' && in + 1 < end) {
+                c = *(++in);
+            }
+            *out++ = c;
+            in++;
+        }
+        if (quote != 0) {
+            return false;
+        }
+        // The terminator either replaces the separator, lands on a character already consumed or in the slack after the contents
+        *out = 0;
+        in++;
+        _cli_push_arg(result, cap, arg);
+    }
+    return true;
+}
+#endif
+
+/**
+ * @brief Expands arguments of the form @path into the arguments read from the file at path. Arguments after `--` are never expanded. The expanded argv is stored in the result. Without response files the result refers to the given argv and nothing is allocated.
+ * @param result The result receiving the expanded argv and the response files
+ * @param argc The argc value
+ * @param argv The argv array
+ * @return False if a response file could not be read or has an unterminated quote, else true
+ * @note Define CCLI_NO_RESPONSE_FILES before including the implementation to treat @path like any other argument
+ */
+bool _cli_expand_response_files(cli_result *result, int argc, char *argv[]) {
+    result->argc = argc;
+    result->argv = argv;
+    result->files = NULL;
+    result->file_count = 0;
+#ifndef CCLI_NO_RESPONSE_FILES
+    int first = 0;
+    for (int i = 1; i < argc && first == 0; i++) {
+        if (cli_streq(argv[i], "--")) {
+            break;
+        }
+        if (argv[i][0] == '@' && argv[i][1] != 0) {
+            first = i;
+        }
+    }
+    if (first == 0) {
+        return true;
+    }
+
+    size_t arg_cap = 0;
+    size_t file_cap = 0;
+    bool done = false;
+    result->argc = 0;
+    result->argv = NULL;
+    for (int i = 0; i < argc; i++) {
+        char *arg = argv[i];
+        done = done || cli_streq(arg, "--");
+        if (i < first || done || arg[0] != '@' || arg[1] == 0) {
+            _cli_push_arg(result, &arg_cap, arg);
+            continue;
+        }
+        _cli_grow(result->arena, (void **)&result->files, &file_cap, result->file_count, sizeof(cli_response_file));
+        cli_response_file *file = &result->files[result->file_count];
+        if (!_cli_read_file(result, arg + 1, file)) {
+            int error = errno;
+            // Error indices refer to the expanded argv, so the failing argument is kept at its end
+            _cli_push_arg(result, &arg_cap, arg);
+            return _cli_fail(result, cli_err_response_file, result->argc - 1, "Could not read response file `%s`: %s", arg + 1, strerror(error));
+        }
+        result->file_count++;
+        if (!_cli_tokenize_response_file(file, result, &arg_cap)) {
+            _cli_push_arg(result, &arg_cap, arg);
+            return _cli_fail(result, cli_err_response_file, result->argc - 1, "Unterminated quote in response file `%s`", arg + 1);
+        }
+    }
+#endif
+    return true;
+}
+
+/**
+ * @brief Returns the layer to merge at the given position: the layers of the parser followed by the config file and the environment.
+ * @param parser The parser holding the additional layers
+ * @param file The layer of the config file
+ * @param env The layer of the environment
+ * @param idx The position of the layer
+ * @return The layer
+ */
+const cli_layer *_cli_merge_layer(const cli_parser *parser, const cli_layer *file, const cli_layer *env, size_t idx) {
+    if (idx < parser->layer_count) {
+        return &parser->layers[idx];
+    }
+    return idx == parser->layer_count ? file : env;
+}
+
+/**
+ * @brief Merges the layers beneath argv into the result. The first pass over the entries raises the source of every option to the highest rank setting it, the second stores the values of the winning layers and a final pass over the options marks them as matched. Nothing but the winning values is ever stored.
+ * @param parser The parser holding the options and the additional layers
+ * @param result The result of the current parse
+ * @param cmd_idx The index of the invoked command. Entries of options outside of it are ignored
+ * @param file The layer of the config file
+ * @param env The layer of the environment
+ * @param sources Receives the source of the value of every option
+ */
+void _cli_merge_layers(const cli_parser *parser, cli_result *result, uint64_t cmd_idx, const cli_layer *file, const cli_layer *env, uint8_t *sources) {
+    size_t layer_count = parser->layer_count + 2;
+    for (uint32_t i = 0; i < parser->opt_count; i++) {
+        sources[i] = _cli_is_matched(parser, result, i) ? (uint8_t)cli_source_argv : (uint8_t)cli_source_none;
+    }
+    for (size_t l = 0; l < layer_count; l++) {
+        const cli_layer *layer = _cli_merge_layer(parser, file, env, l);
+        if (!_cli_layer_ranked(layer)) {
+            continue;
+        }
+        for (size_t e = 0; e < layer->len; e++) {
+            uint32_t opt_idx = layer->entries[e].opt_idx;
+            if (opt_idx >= parser->opt_count) {
+                cli_panicf("Layer holds a value for the unknown option %u", opt_idx);
+            }
+            if ((uint8_t)layer->source > sources[opt_idx] && _cli_opt_in_cmd(&parser->index, opt_idx, cmd_idx)) {
+                sources[opt_idx] = (uint8_t)layer->source;
+            }
+        }
+    }
+    for (size_t l = 0; l < layer_count; l++) {
+        const cli_layer *layer = _cli_merge_layer(parser, file, env, l);
+        if (!_cli_layer_ranked(layer)) {
+            continue;
+        }
+        for (size_t e = 0; e < layer->len; e++) {
+            uint32_t opt_idx = layer->entries[e].opt_idx;
+            if ((sources[opt_idx] & ~CLI_SOURCE_APPLIED) == (uint8_t)layer->source) {
+                _cli_store_value(parser, result, opt_idx, &layer->entries[e].value, (sources[opt_idx] & CLI_SOURCE_APPLIED) == 0);
+                sources[opt_idx] |= CLI_SOURCE_APPLIED;
+            }
         }
     }
-
-    if (examples != NULL) {
-        printf("\nExamples:\n");
-        cli_example example;
-        size_t idx = 0;
-        while ((example = examples[idx++]).options != NULL) {
-            printf("%s %s\t%s\n", argv[0], example.options, example.description);
+    for (uint32_t i = 0; i < parser->opt_count; i++) {
+        sources[i] &= ~CLI_SOURCE_APPLIED;
+        if (sources[i] > cli_source_default) {
+            _cli_set_matched(parser, result, i);
         }
     }
-
-    printf("\n\nUse `%s [command] --help` to get help for a specific command\n", argv[0]);
 }
 
 /**
- * @brief Returns whether the given option is a long style option or not.
- * @param opt The string of the option to check
- * @return True if the option is a long option, false if not
+ * @brief Applies a single line of the config file. The line is terminated in place.
+ * @param parser The parser holding the options and commands
+ * @param result The result of the current parse
+ * @param cmd_idx The index of the invoked command
+ * @param line The line without the line break
+ * @param line_no The number of the line for error messages
+ * @param section The command of the current section, 1 before the first header and 0 in sections of other commands
+ * @param layer Receives the converted value
+ * @return False if the line is invalid, else true
  */
-bool _cli_is_long_opt(char *opt) {
-    size_t len = strlen(opt);
-    if (len < 3) {
-        return false;
+bool _cli_parse_config_line(const cli_parser *parser, cli_result *result, uint64_t cmd_idx, char *line, size_t line_no, uint64_t *section, cli_layer *layer) {
+    char *end = line + strlen(line);
+    while (_cli_is_space(*line)) {
+        line++;
+    }
+    while (end > line && _cli_is_space(end[-1])) {
+        end--;
+    }
+    *end = 0;
+    if (line == end || line[0] == '#' || line[0] == ';') {
+        return true;
+    }
+    if (line[0] == '[') {
+        if (end[-1] != ']') {
+            return _cli_fail(result, cli_err_config_file, -1, "Invalid section in config file `%s` on line %zu: %s", parser->config_path, line_no, line);
+        }
+        end[-1] = 0;
+        *section = cmd_idx > 1 && cli_streq(line + 1, parser->commands[cmd_idx - 2].command) ? cmd_idx : 0;
+        return true;
+    }
+    if (*section == 0) {
+        return true;
+    }
+
+    char *key_end = strchr(line, '=');
+    char *value = NULL;
+    if (key_end != NULL) {
+        value = key_end + 1;
+        while (_cli_is_space(*value)) {
+            value++;
+        }
+        if (end - value >= 2 && (value[0] == '"' || value[0] == '\'') && end[-1] == value[0]) {
+            value++;
+            end[-1] = 0;
+        }
+    } else {
+        key_end = end;
+    }
+    while (key_end > line && _cli_is_space(key_end[-1])) {
+        key_end--;
+    }
+    uint32_t opt_idx = _cli_index_find_long_n(&parser->index, parser->options, line, (size_t)(key_end - line), *section);
+    if (opt_idx == CLI_INDEX_END) {
+        return _cli_fail(result, cli_err_config_file, -1, "Unknown option `%.*s` in config file `%s` on line %zu", (int)(key_end - line), line, parser->config_path, line_no);
+    }
+    cli_option opt = parser->options[opt_idx];
+    if (*section != cmd_idx && _cli_opt_cmd(&opt) != 0) {
+        return true;
+    }
+    cli_data data;
+    if (CLI_ARG_TYPE(opt.params) == boolean) {
+        data.bool_data = value == NULL || _cli_is_truthy(value);
+    } else if (value == NULL) {
+        return _cli_fail(result, cli_err_config_file, -1, "Missing value for option `%s` in config file `%s` on line %zu", opt.long_arg, parser->config_path, line_no);
+    } else if (!_cli_convert_value(parser, result, -1, opt_idx, value, &data)) {
+        return _cli_fail(result, result->error.status, -1, "Invalid value for option `%s` in config file `%s` on line %zu: %s", opt.long_arg, parser->config_path, line_no, value);
     }
-    return opt[0] == '-' && opt[0] == opt[1];
+    _cli_layer_push(result->arena, layer, opt_idx, data);
+    return true;
 }
 
 /**
- * @brief Determines the type of short option for the given string.
- * @param opt The string of the option to check
- * @return The type of the short option as described in @ref short_opt_type_t
+ * @brief Collects the values of the config file of the parser. The file is memory-mapped and split into lines in place, so string values point into the mapping. Lines of sections belonging to other commands are skipped without looking at them.
+ * @param parser The parser holding the options, commands and the path of the config file
+ * @param result The result of the current parse receiving the file
+ * @param cmd_idx The index of the invoked command
+ * @param layer Receives the converted values
+ * @return False if the file could not be read or contains an invalid line, else true. A missing file is not an error
  */
-cli_short_opt_type _cli_short_opt_type(char *opt) {
-    size_t len = strlen(opt);
-    if (len < 2) {
-        return none;
+bool _cli_parse_config(const cli_parser *parser, cli_result *result, uint64_t cmd_idx, cli_layer *layer) {
+    if (parser->config_path == NULL) {
+        return true;
     }
-
-    if (opt[0] != '-') {
-        return none;
+    if (!_cli_read_file(result, parser->config_path, &result->config)) {
+        return errno == ENOENT || _cli_fail(result, cli_err_config_file, -1, "Could not read config file `%s`: %s", parser->config_path, strerror(errno));
     }
-
-    if (len >= 3) {
-        return multiple;
+    char *in = result->config.data;
+    char *end = in + result->config.len;
+    uint64_t section = 1;
+    bool ok = true;
+    for (size_t line_no = 1; ok && in < end; line_no++) {
+        char *eol = (char *)memchr(in, '\n', (size_t)(end - in));
+        if (eol == NULL) {
+            eol = end;
+        }
+        // Like in response files the terminator of the last line lands in the slack after the contents
+        *eol = 0;
+        ok = _cli_parse_config_line(parser, result, cmd_idx, in, line_no, &section, layer);
+        in = eol + 1;
     }
-
-    return opt[0] == '-' && opt[1] != '-' ? single : none;
+    return ok;
 }
 
 /**
- * @brief Returns whether the given string is an option or not.
- * @param opt The string if the option to check
- * @return True if the string is an option, else false
- * @note See @ref _short_opt_type and @ref _is_long_opt
+ * @def CLI_SNAPSHOT_MAGIC
+ * @brief Marks a snapshot file and the version of its layout.
  */
-bool _cli_is_option(char *opt) {
-    return _cli_is_long_opt(opt) || _cli_short_opt_type(opt) != none;
-}
+#define CLI_SNAPSHOT_MAGIC 0x32504e53494c4343ull
 
 /**
- * @brief Parses all the remaining values in argv as positional options. Errors if the amount does not coincide with the amount of positional options in the option array in the context of the given command.
- * @param options The zero-terminated array of @ref option_t
- * @param commands The zero-terminated array of @ref command_t
- * @param command Name of the current command
- * @param argc_idx The index to start the parsing from
- * @param argc The total length of argv
- * @param argv The argv array
+ * @brief Header of a snapshot file. It is followed by the entries, the items of the lists as offsets and the zero-terminated strings.
  */
-void _cli_parse_remaining_positionals(cli_option *options, cli_command *commands, char *command, int argc_idx, int argc, char **argv) {
-    size_t pos_arg_count = _cli_pos_args_len(options, commands, command);
-    if (argc - argc_idx - 1 > pos_arg_count) {
-        cli_fatalf_help(argv[0], "Too many positional arguments: Expected %d got %d", pos_arg_count, argc - argc_idx - 1);
-    }
+typedef struct {
+    uint64_t magic;       /**< Always @ref CLI_SNAPSHOT_MAGIC */
+    uint64_t key;         /**< The hash of everything the parse depends on */
+    uint64_t size;        /**< The size of the whole snapshot */
+    uint64_t cmd_idx;     /**< The invoked command */
+    uint32_t opt_count;   /**< The amount of options of the parser */
+    uint32_t entry_count; /**< The amount of options set by any source */
+} cli_snapshot_header;
 
-    for (; argc_idx < argc; argc_idx++) {
-        char *arg = argv[argc_idx];
-        if (strcmp(arg, "--") == 0 || strcmp(arg, "-") == 0) {
-            continue;
-        }
-        for (size_t opt_search = 0; opt_search < _cli_opt_len(options); opt_search++) {
-            cli_option opt = options[opt_search];
-            if (!(CLI_ARG_MATCHED(opt.params)) && CLI_ARG_POSITIONAL(opt.params)) {
-                options[opt_search].params = CLI_ARG_SET_MATCHED(opt.params);
-                options[opt_search].data->str_data = arg;
-            }
-        }
-    }
+/**
+ * @brief The value of an option in a snapshot file.
+ */
+typedef struct {
+    uint32_t opt_idx; /**< The index of the option */
+    uint32_t source;  /**< The @ref cli_source of the value */
+    uint64_t len;     /**< The amount of values of a list option */
+    uint64_t data;    /**< The value of a boolean or number option or the offset of the string or the list items */
+} cli_snapshot_entry;
 
-    if (argc_idx != argc) {
-        cli_fatalf_help(argv[0], "Too few positional arguments: Expected %d got %d", pos_arg_count, argc - argc_idx);
+/**
+ * @brief Continues a 64 bit FNV-1a hash with the given bytes.
+ * @param hash The hash so far
+ * @param data The bytes to hash
+ * @param len The amount of bytes
+ * @return The continued hash
+ */
+uint64_t _cli_hash64_continue(uint64_t hash, const void *data, size_t len) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
     }
+    return hash;
 }
 
 /**
- * @brief Returns whether the given string is equal to the name of the given option.
- * @param argv_opt The string to test
- * @param long_opt The name of the option
- * @return True if the options match, else false
- * @note The function checks if the long_opt with prepended '--' is equal to the given argv_opt
+ * @brief Continues a 64 bit hash with a zero-terminated string including its terminator, or a single zero byte for NULL.
+ * @param hash The hash so far
+ * @param s The string to hash
+ * @return The continued hash
  */
-bool _cli_long_opt_eq(char *argv_opt, char *long_opt) {
-    if (argv_opt == NULL || long_opt == NULL) {
-        return false;
-    }
-    char *long_opt_with_dash = (char *)malloc(sizeof(char) * strlen(long_opt) + 3);
-    cli_check_alloc(long_opt_with_dash);
-    memcpy(long_opt_with_dash + 2, long_opt, strlen(long_opt) + 1);
-    long_opt_with_dash[0] = long_opt_with_dash[1] = '-';
-    bool are_eq = strcmp(argv_opt, long_opt_with_dash) == 0;
-    free(long_opt_with_dash);
-    return are_eq;
+uint64_t _cli_hash64_str(uint64_t hash, const char *s) {
+    return s == NULL ? _cli_hash64_continue(hash, "", 1) : _cli_hash64_continue(hash, s, strlen(s) + 1);
 }
 
 /**
- * @brief Checks if any required options in the context of the given command are not set. Errors on the first violation.
- * @param cmd_idx The index of the command
- * @param options The zero-terminated array of @ref option_t
- * @param mutual_exclusions The zero-terminated array of @ref exclusion_t to know if two required options are mutually exclusive
+ * @brief Continues a 64 bit hash with the identity of the file at the given path, i.e. its path, device, inode, size and modification and change times down to the nanosecond.
+ * @param hash The hash so far
+ * @param path The path of the file
+ * @param racy Set to true if the file changed within the last two seconds, in which case a later write may not move its times
+ * @return The continued hash
  */
-void _cli_check_unmatched(const char *bin, uint8_t cmd_idx, cli_option *options, cli_exclusion mutual_exclusions[]) {
-    for (size_t opt_search = 0; opt_search < _cli_opt_len(options); opt_search++) {
-        cli_option opt = options[opt_search];
-        if (!(CLI_ARG_GLOBAL(opt.params)) && CLI_ARG_CMD(opt.params) != cmd_idx) {
-            continue;
-        }
-        if (!(CLI_ARG_MATCHED(opt.params))) {
-            if (CLI_ARG_REQUIRED(opt.params)) {
-                size_t idx = 0;
-                cli_exclusion ex;
-                bool can_proceed = false;
-                if (mutual_exclusions != NULL) {
-                    while ((ex = mutual_exclusions[idx++]).one != NULL) {
-                        if (cli_streq(ex.one, opt.long_arg) || cli_streq(ex.other, opt.long_arg)) {
-                            can_proceed = true;
-                            break;
-                        }
-                    }
-                }
-                if (can_proceed) {
-                    continue;
-                }
-                cli_fatalf_help(bin, "Missing required argument `%s`", opt.long_arg);
-            }
+uint64_t _cli_hash64_file(uint64_t hash, const char *path, bool *racy) {
+    uint64_t id[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        time_t now = time(NULL);
+        id[0] = (uint64_t)st.st_dev;
+        id[1] = (uint64_t)st.st_ino;
+        id[2] = (uint64_t)st.st_size;
+        id[3] = (uint64_t)st.st_mtime;
+        id[4] = (uint64_t)CLI_STAT_MTIME_NSEC(st);
+        id[5] = (uint64_t)st.st_ctime;
+        id[6] = (uint64_t)CLI_STAT_CTIME_NSEC(st);
+        id[7] = 1;
+        if (now - st.st_mtime < 2 || now - st.st_ctime < 2) {
+            *racy = true;
         }
     }
+    return _cli_hash64_continue(_cli_hash64_str(hash, path), id, sizeof(id));
 }
 
 /**
- * @brief Finds the help command among the given options to instantly print the help menu.
- * @param commands All commands of the cli. Set to NULL if there are no commands else a zero-terminated array of @ref command_t
- * @param command Name of the current command
- * @param options All options of the cli as a zero-terminated array of @ref option_t
+ * @brief Hashes everything a parse depends on: the tables and exclusions, whether abbreviations are allowed, the arguments, the response files, the bound environment variables, the config file and the additional layers.
+ * @param parser The parser
  * @param argc The argc value
  * @param argv The argv array
- * @param examples Optional zero-terminated array of examples
+ * @return The key of the snapshot, or 0 if a file it depends on changed too recently to be told apart from a later change
  */
-void _cli_find_help(cli_command *commands, char *command, cli_option *options, int argc, char *argv[], cli_example *examples) {
-    for (int i = 1; i < argc; i++) {
-        char *arg = argv[i];
-        if (strcmp(arg, "--") == 0 || strcmp(arg, "-") == 0) {
-            return;
+uint64_t _cli_snapshot_key(const cli_parser *parser, int argc, char *argv[]) {
+    bool racy = false;
+    uint64_t hash = _cli_hash64_continue(14695981039346656037ull, "ccli", 4);
+    uint64_t sizes[3] = {CLI_SNAPSHOT_MAGIC, sizeof(char *), parser->opt_count};
+    hash = _cli_hash64_continue(hash, sizes, sizeof(sizes));
+    for (size_t i = 0; parser->commands != NULL && parser->commands[i].command != NULL; i++) {
+        hash = _cli_hash64_str(hash, parser->commands[i].command);
+    }
+    for (size_t i = 0; i < parser->opt_count; i++) {
+        uint64_t params = parser->options[i].params & ~CLI_ARG_MAT_MASK;
+        hash = _cli_hash64_continue(hash, &params, sizeof(params));
+        hash = _cli_hash64_continue(hash, &parser->options[i].short_arg, 1);
+        hash = _cli_hash64_str(hash, parser->options[i].long_arg);
+    }
+    for (size_t i = 0; parser->exclusions != NULL && parser->exclusions[i].one != NULL; i++) {
+        hash = _cli_hash64_str(_cli_hash64_str(hash, parser->exclusions[i].one), parser->exclusions[i].other);
+    }
+    hash = _cli_hash64_continue(hash, &parser->abbreviations, sizeof(bool));
+    for (int i = 0; i < argc; i++) {
+        hash = _cli_hash64_str(hash, argv[i]);
+        if (argv[i][0] == '@' && argv[i][1] != 0) {
+            hash = _cli_hash64_file(hash, argv[i] + 1, &racy);
         }
-        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
-            cli_help(commands, command, options, argv, examples);
-            exit(0);
+    }
+    hash = _cli_hash64_str(hash, parser->env_prefix);
+    for (char **env = environ; parser->env_prefix != NULL && env != NULL && *env != NULL; env++) {
+        if (strncmp(*env, parser->env_prefix, parser->env_prefix_len) == 0 && (*env)[parser->env_prefix_len] == '_') {
+            hash = _cli_hash64_str(hash, *env);
+        }
+    }
+    for (size_t l = 0; l < parser->layer_count; l++) {
+        const cli_layer *layer = &parser->layers[l];
+        uint64_t header[2] = {(uint64_t)layer->source, layer->len};
+        hash = _cli_hash64_continue(hash, header, sizeof(header));
+        for (size_t e = 0; e < layer->len; e++) {
+            const cli_layer_entry *entry = &layer->entries[e];
+            uint64_t type = entry->opt_idx < parser->opt_count ? CLI_ARG_TYPE(parser->options[entry->opt_idx].params) : (uint64_t)boolean;
+            hash = _cli_hash64_continue(hash, &entry->opt_idx, sizeof(entry->opt_idx));
+            if (type == string || type == list) {
+                hash = _cli_hash64_str(hash, entry->value.str_data);
+            } else if (type == boolean) {
+                hash = _cli_hash64_continue(hash, &entry->value.bool_data, sizeof(bool));
+            } else {
+                hash = _cli_hash64_continue(hash, &entry->value.unum_data, sizeof(uint64_t));
+            }
         }
     }
+    if (parser->config_path != NULL) {
+        hash = _cli_hash64_file(hash, parser->config_path, &racy);
+    }
+    return racy ? 0 : hash | 1;
 }
 
 /**
- * @brief Checks if any mutual exclusions are violated. Errors on the first violation.
- * @param cmd_idx The index of the command
- * @param options The zero-terminated array of @ref option_t
- * @param mutual_exclusions The zero-terminated array of @ref exclusion_t to know if two required options are mutually exclusive
+ * @brief Restores the values of a parse from the snapshot of the parser if its key matches. The snapshot is mapped privately and the offsets of the list items are turned into pointers in place, so restoring takes one step per matched option.
+ * @param parser The parser holding the path of the snapshot
+ * @param result The result of the current parse receiving the snapshot
+ * @param key The key of the current parse
+ * @return True if the values were restored, false if the snapshot is missing, stale or invalid
  */
-void _cli_check_mutual_exclusions(const char *bin, uint8_t cmd_idx, cli_option *options, cli_exclusion mutual_exclusions[]) {
-    if (mutual_exclusions == NULL) {
-        return;
+bool _cli_snapshot_load(const cli_parser *parser, cli_result *result, uint64_t key) {
+    cli_response_file *file = &result->snapshot;
+    if (!_cli_read_file(result, parser->snapshot_path, file)) {
+        return false;
     }
-    size_t idx = 0;
-    cli_exclusion exclusion;
-    while ((exclusion = mutual_exclusions[idx++]).one != NULL) {
-        if (exclusion.other == NULL) {
-            cli_panic("check_mutual_exclusions: NULL in non NULL exclusion!");
+    char *base = file->data;
+    const cli_snapshot_header *header = (const cli_snapshot_header *)base;
+    size_t entries_end = sizeof(cli_snapshot_header);
+    bool valid = file->len > sizeof(cli_snapshot_header) && header->magic == CLI_SNAPSHOT_MAGIC && header->key == key && header->size == file->len && header->opt_count == parser->opt_count && base[file->len - 1] == 0;
+    if (valid) {
+        entries_end += (size_t)header->entry_count * sizeof(cli_snapshot_entry);
+        valid = header->entry_count <= header->opt_count && entries_end <= file->len && header->cmd_idx >= 1 && header->cmd_idx <= parser->cmd_count + 1;
+    }
+    const cli_snapshot_entry *entries = (const cli_snapshot_entry *)(base + sizeof(cli_snapshot_header));
+    for (uint32_t i = 0; valid && i < header->entry_count; i++) {
+        cli_snapshot_entry entry = entries[i];
+        valid = entry.opt_idx < parser->opt_count && entry.source != cli_source_none && entry.source < CLI_SOURCE_APPLIED && entry.len <= UINT32_MAX;
+        uint64_t type = valid ? CLI_ARG_TYPE(parser->options[entry.opt_idx].params) : (uint64_t)boolean;
+        if (type == string) {
+            valid = entry.data == 0 || (entry.data >= entries_end && entry.data < file->len);
+        } else if (type == list) {
+            valid = entry.data >= entries_end && entry.data % sizeof(uintptr_t) == 0 && entry.data + (uint64_t)entry.len * sizeof(uintptr_t) <= file->len;
+            for (uint32_t j = 0; valid && j < entry.len; j++) {
+                uintptr_t offset = ((const uintptr_t *)(base + entry.data))[j];
+                valid = offset >= entries_end && offset < file->len;
+            }
         }
-        if (strlen(exclusion.one) == 0 || strlen(exclusion.other) == 0) {
-            cli_panic("check_mutual_exclusions: Empty exclusion!");
+    }
+    if (!valid) {
+        if (file->mapped) {
+            munmap(file->data, file->len);
+        } else {
+            _cli_release(result, file->data);
         }
-        bool one_matched = false;
-        bool other_matched = false;
-        bool both_required = true;
-        bool irrelevant = false;
-        for (int i = 0; i < _cli_opt_len(options); i++) {
-            cli_option opt = options[i];
-            if (!(CLI_ARG_GLOBAL(opt.params)) && CLI_ARG_CMD(opt.params) != cmd_idx && (cli_streq(exclusion.one, opt.long_arg) || cli_streq(exclusion.other, opt.long_arg))) {
-                irrelevant = true;
-                break;
-            }
-            if (cli_streq(exclusion.one, opt.long_arg)) {
-                one_matched = CLI_ARG_MATCHED(opt.params);
-                both_required &= CLI_ARG_REQUIRED(opt.params);
-                continue;
-            }
-            if (cli_streq(exclusion.other, opt.long_arg)) {
-                other_matched = CLI_ARG_MATCHED(opt.params);
-                both_required &= CLI_ARG_REQUIRED(opt.params);
-                continue;
-            }
+        memset(file, 0, sizeof(cli_response_file));
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header->entry_count; i++) {
+        cli_snapshot_entry entry = entries[i];
+        cli_data *value = _cli_value(parser, result, entry.opt_idx);
+        if (entry.source > cli_source_default) {
+            _cli_set_matched(parser, result, entry.opt_idx);
         }
-        if (irrelevant) {
-            continue;
+        if (result->sources != NULL) {
+            result->sources[entry.opt_idx] = (uint8_t)entry.source;
         }
-        if (one_matched == false && other_matched == false && both_required) {
-            cli_fatalf_help(bin, "One of the options `%s` and `%s` is required because they are both required but mutually exclusive", exclusion.one, exclusion.other);
+        switch (CLI_ARG_TYPE(parser->options[entry.opt_idx].params)) {
+        case boolean:
+            value->bool_data = entry.data != 0;
+            break;
+        case number:
+            value->num_data = (int64_t)entry.data;
+            break;
+        case unumber:
+            value->unum_data = entry.data;
+            break;
+        case string:
+            value->str_data = entry.data != 0 ? base + entry.data : NULL;
+            break;
+        case list: {
+            uintptr_t *items = (uintptr_t *)(base + entry.data);
+            for (uint32_t j = 0; j < entry.len; j++) {
+                items[j] = (uintptr_t)(base + items[j]);
+            }
+            value->list_data.items = (char **)items;
+            value->list_data.len = (size_t)entry.len;
+            value->list_data.cap = 0;
+            break;
         }
-        if (one_matched == true && other_matched == true) {
-            cli_fatalf_help(bin, "Options `%s` and `%s` are mutually exclusive. Please provide only one of them", exclusion.one, exclusion.other);
         }
     }
+    result->cmd_idx = (size_t)header->cmd_idx;
+    result->command = header->cmd_idx > 1 ? parser->commands[header->cmd_idx - 2].command : NULL;
+    return true;
 }
 
 /**
- * @brief Checks for which command is being run. Adheres to the specification in @ref ARG_MAKE.
- * @param commands The zero-terminated array of @ref command_t
- * @param argc The length of argv
- * @param argv The argv array
- * @returns A number <= 1 representing the command which is being run
+ * @brief Copies a string into a snapshot that is being built.
+ * @param blob The snapshot
+ * @param at The offset of the next free byte in the snapshot. Advanced past the copy
+ * @param s The string to copy. NULL is stored as offset 0
+ * @return The offset of the copy
  */
-size_t _run_command(cli_command *commands, int argc, char *argv[]) {
-    if (argc == 1) {
-        return 1;
-    }
-    for (size_t i = 0; i < _cli_cmd_len(commands); i++) {
-        cli_command cmd = commands[i];
-        if (cli_streq(cmd.command, argv[1])) {
-            return i + 2;
-        }
+uint64_t _cli_snapshot_string(char *blob, size_t *at, const char *s) {
+    if (s == NULL) {
+        return 0;
     }
-    return 1;
+    size_t len = strlen(s) + 1;
+    size_t offset = *at;
+    memcpy(blob + offset, s, len);
+    *at += len;
+    return offset;
 }
 
 /**
- * @brief Parses an option of type --opt=arg.
- * @param options The zero-terminated array of @ref option_t
- * @param arg The string argument passed down to the cli
- * @param cmd_idx The index of the command
+ * @brief Writes the values of a successful parse to the snapshot of the parser. The snapshot is written to a temporary file that is created exclusively under a name unique to the process and thread, and then renamed, so no other parse, in this or another process, writes to it or maps a partial snapshot. Failing to write the snapshot is not an error, the next parse simply misses it.
+ * @param parser The parser holding the path of the snapshot
+ * @param result The result of the successful parse
+ * @param key The key of the parse
+ * @param sources The source of every option or NULL if only argv set values
  */
-void _cli_parse_equals(const char *bin, cli_option *options, char *arg, uint64_t cmd_idx) {
-    size_t total_len = strlen(arg);
-    size_t pre_len = cli_stridx(arg, '=');
-    size_t post_len = total_len - pre_len - 1;
-    char *opt_str = (char *)malloc((pre_len + 1) * sizeof(char));
-    cli_check_alloc(opt_str);
-    memcpy(opt_str, arg, pre_len);
-    opt_str[pre_len] = 0;
-    char *param = (char *)malloc((post_len + 1) * sizeof(char));
-    cli_check_alloc(param);
-    memcpy(param, arg + pre_len + 1, post_len);
-    param[post_len] = 0;
-    size_t opt_count = _cli_opt_len(options);
-    bool matched_arg = false;
-    for (size_t opt_search = 0; opt_search < opt_count; opt_search++) {
-        cli_option opt = options[opt_search];
-        if (!(CLI_ARG_GLOBAL(opt.params)) && !(CLI_ARG_CMD(opt.params) == cmd_idx)) {
+void _cli_snapshot_save(const cli_parser *parser, cli_result *result, uint64_t key, const uint8_t *sources) {
+    size_t entry_count = 0;
+    size_t slot_count = 0;
+    size_t str_len = 0;
+    for (uint32_t i = 0; i < parser->opt_count; i++) {
+        if (sources != NULL ? sources[i] == cli_source_none : !_cli_is_matched(parser, result, i)) {
             continue;
         }
-        if (_cli_long_opt_eq(opt_str, opt.long_arg) || opt_str[1] == opt.short_arg) {
-            matched_arg = true;
-            options[opt_search].params = CLI_ARG_SET_MATCHED(opt.params);
+        entry_count++;
+        cli_data *value = _cli_value(parser, result, i);
+        if (CLI_ARG_TYPE(parser->options[i].params) == string && value->str_data != NULL) {
+            str_len += strlen(value->str_data) + 1;
+        } else if (CLI_ARG_TYPE(parser->options[i].params) == list) {
+            slot_count += value->list_data.len;
+            for (size_t j = 0; j < value->list_data.len; j++) {
+                str_len += strlen(value->list_data.items[j]) + 1;
+            }
+        }
+    }
+    size_t slots_at = sizeof(cli_snapshot_header) + entry_count * sizeof(cli_snapshot_entry);
+    size_t strings_at = slots_at + slot_count * sizeof(uintptr_t);
+    size_t size = strings_at + str_len + 1;
+    char *blob = (char *)CLI_MALLOC(size);
+    cli_check_alloc(blob);
+    memset(blob, 0, size);
+
+    cli_snapshot_header *header = (cli_snapshot_header *)blob;
+    header->magic = CLI_SNAPSHOT_MAGIC;
+    header->key = key;
+    header->size = size;
+    header->cmd_idx = result->cmd_idx;
+    header->opt_count = (uint32_t)parser->opt_count;
+    header->entry_count = (uint32_t)entry_count;
+    cli_snapshot_entry *entry = (cli_snapshot_entry *)(blob + sizeof(cli_snapshot_header));
+    uintptr_t *slots = (uintptr_t *)(blob + slots_at);
+    size_t at = strings_at;
+    for (uint32_t i = 0; i < parser->opt_count; i++) {
+        if (sources != NULL ? sources[i] == cli_source_none : !_cli_is_matched(parser, result, i)) {
+            continue;
+        }
+        cli_data *value = _cli_value(parser, result, i);
+        entry->opt_idx = i;
+        entry->source = sources != NULL ? sources[i] : (uint32_t)cli_source_argv;
+        switch (CLI_ARG_TYPE(parser->options[i].params)) {
+        case boolean:
+            entry->data = value->bool_data;
+            break;
+        case number:
+            entry->data = (uint64_t)value->num_data;
+            break;
+        case unumber:
+            entry->data = value->unum_data;
+            break;
+        case string:
+            entry->data = _cli_snapshot_string(blob, &at, value->str_data);
+            break;
+        case list:
+            entry->data = (uint64_t)((char *)slots - blob);
+            entry->len = value->list_data.len;
+            for (size_t j = 0; j < value->list_data.len; j++) {
+                *slots++ = (uintptr_t)_cli_snapshot_string(blob, &at, value->list_data.items[j]);
+            }
+            break;
+        }
+        entry++;
+    }
 
-            if (CLI_ARG_TYPE(opt.params) == boolean) {
-                free(opt_str);
-                cli_fatalf_help(bin, "Invalid flag usage. Option `%s` does not expect an argument", opt.long_arg);
-            } else {
-                if (CLI_ARG_TYPE(opt.params) == string) {
-                    options[opt_search].data->str_data = param;
-                } else if (CLI_ARG_TYPE(opt.params) == number) {
-                    char *arg_num_param = param;
-                    int64_t arg_num_parse_res = 0;
-
-                    if (cli_try_parse_int(arg_num_param, &arg_num_parse_res)) {
-                        options[opt_search].data->num_data = arg_num_parse_res;
-                    } else {
-                        free(opt_str);
-                        cli_fatalf(bin, "Invalid numerical sequence for option `%s`: %s", opt.long_arg, arg_num_param);
-                    }
-                } else if (CLI_ARG_TYPE(opt.params) == unumber) {
-                    char *arg_unum_param = param;
-                    uint64_t arg_unum_parse_res = 0;
+    size_t path_len = strlen(parser->snapshot_path);
+    char *tmp_path = (char *)CLI_MALLOC(path_len + 64);
+    cli_check_alloc(tmp_path);
+    int fd = -1;
+    for (unsigned attempt = 0; fd < 0 && attempt < 16; attempt++) {
+        // The stack address tells apart threads of the same process, the attempt number retries names left behind
+        snprintf(tmp_path, path_len + 64, "%s.%ld.%lx.%u.tmp", parser->snapshot_path, (long)getpid(), (unsigned long)(uintptr_t)&fd, attempt);
+        fd = open(tmp_path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd < 0 && errno != EEXIST && errno != EINTR) {
+            break;
+        }
+    }
+    bool written = fd >= 0;
+    for (size_t done = 0; written && done < size;) {
+        ssize_t count = write(fd, blob + done, size - done);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        written = count > 0;
+        done += written ? (size_t)count : 0;
+    }
+    if (fd >= 0) {
+        written = close(fd) == 0 && written;
+    }
+    if (fd >= 0 && (!written || rename(tmp_path, parser->snapshot_path) != 0)) {
+        unlink(tmp_path);
+    }
+    CLI_FREE(tmp_path);
+    CLI_FREE(blob);
+}
 
-                    if (cli_try_parse_uint(arg_unum_param, &arg_unum_parse_res)) {
-                        options[opt_search].data->num_data = arg_unum_parse_res;
-                    } else {
-                        free(opt_str);
-                        cli_fatalf(bin, "Invalid numerical sequence for option `%s`: %s", opt.long_arg, arg_unum_param);
-                    }
-                } else {
-                    cli_panic("Unrecognized type of flag encountered!");
-                }
-            }
+/**
+ * @brief Releases the response files, the config file and the snapshot read during a parse together with the expanded argv. The string values of the parse may point into the files, so call it once they are no longer needed. If the parse used an arena it has to be still set in the result, the memory from the arena is released with the arena.
+ * @param result The result to release
+ */
+void cli_result_free(cli_result *result) {
+#ifndef CCLI_NO_RESPONSE_FILES
+    for (size_t i = 0; i < result->file_count; i++) {
+        if (result->files[i].mapped) {
+            munmap(result->files[i].data, result->files[i].len);
+        } else {
+            _cli_release(result, result->files[i].data);
         }
     }
-    if (!matched_arg) {
-        free(opt_str);
-        cli_fatalf_help(bin, "Unknown argument `%s`", arg);
+    if (result->files != NULL) {
+        _cli_release(result, result->files);
+        _cli_release(result, result->argv);
+    }
+#endif
+    if (result->config.mapped) {
+        munmap(result->config.data, result->config.len);
+    } else if (result->config.data != NULL) {
+        _cli_release(result, result->config.data);
+    }
+    memset(&result->config, 0, sizeof(result->config));
+    if (result->snapshot.mapped) {
+        munmap(result->snapshot.data, result->snapshot.len);
+    } else if (result->snapshot.data != NULL) {
+        _cli_release(result, result->snapshot.data);
     }
-    free(opt_str);
+    memset(&result->snapshot, 0, sizeof(result->snapshot));
+    result->files = NULL;
+    result->file_count = 0;
+    result->argv = NULL;
+    result->argc = 0;
 }
 
 /**
- * @brief Parses the values in argv into the options defined in options. Fails automatically if an error during parsing is encountered. If successful all the @ref opt_data_t in the options contain the respective values.
- * @param commands All commands of the cli. Set to NULL if there are no commands else a zero-terminated array of @ref command_t
- * @param options All options of the cli as a zero-terminated array of @ref option_t
+ * @brief Parses the values in argv with a compiled parser without ever exiting the process. If successful all the @ref opt_data_t in the options (or the values of the result) contain the respective values.
+ * @param parser The parser created with @ref cli_parser_compile
  * @param argc The argc value
  * @param argv The argv array
- * @param exclusions Optional zero-terminated array of @ref exclusion_t to respect
- * @param examples Optional zero-terminated array of examples
- * @return The name of the command invoked or NULL if the root command was invoked
+ * @param result The result receiving the invoked command and the error. If its values and matched arrays are set the options are not modified
+ * @return @ref cli_ok on success, @ref cli_help_requested if -h or --help was given, else the kind of error. The error is also stored in the result together with a message and the index of the offending argument
+ * @note The matched state is reset at the start of every call, so the same parser can be used for any number of command lines
+ * @note The parser itself is never modified. If values and matched are supplied in the result any number of threads can parse with the same parser concurrently
+ * @note Arguments of the form @path are replaced with the arguments read from the file at path. Release the files with @ref cli_result_free once the parsed values are no longer needed, also if the parse failed
+ * @note Options not given in argv are taken from the environment, the config file and the additional layers if the parser has them set, see @ref cli_parser_set_env_prefix, @ref cli_parser_set_config_file and @ref cli_parser_set_layers. If the sources array of the result is set it receives the source of every value
+ * @note If the parser has a snapshot whose sources are unchanged the values are restored from it without parsing, see @ref cli_parser_set_snapshot
  */
-char *cli_parse_opts(cli_command *commands, cli_option *options, int argc, char *argv[], cli_exclusion mutual_exclusions[], cli_example examples[]) {
+cli_status cli_parser_try_parse(const cli_parser *parser, int argc, char *argv[], cli_result *result) {
     if (argc == 0 || argv == NULL) {
         cli_panic("argc and argv are required");
     }
 
-    const char *bin = argv[0];
-    _cli_validate_options(options);
-    int cmd_idx = _run_command(commands, argc, argv);
-    char *command = cmd_idx > 1 ? commands[cmd_idx - 2].command : NULL;
-    _cli_find_help(commands, command, options, argc, argv, examples);
-    size_t opt_count = _cli_opt_len(options);
-    for (int argc_idx = 1 + (cmd_idx > 1); argc_idx < argc; argc_idx++) {
+    cli_option *options = parser->options;
+    const cli_index *index = &parser->index;
+    if (result->sources != NULL) {
+        memset(result->sources, 0, parser->opt_count);
+    }
+    if (result->matched != NULL) {
+        memset(result->matched, 0, sizeof(bool) * parser->opt_count);
+    } else {
+        for (size_t i = 0; i < parser->opt_count; i++) {
+            options[i].params &= ~CLI_ARG_MAT_MASK;
+        }
+    }
+    result->error.status = cli_ok;
+    result->error.argv_idx = -1;
+    result->error.message[0] = 0;
+    result->command = NULL;
+    result->cmd_idx = 1;
+    memset(&result->config, 0, sizeof(result->config));
+    memset(&result->snapshot, 0, sizeof(result->snapshot));
+
+    uint64_t snapshot_key = 0;
+    if (parser->snapshot_path != NULL) {
+        snapshot_key = _cli_snapshot_key(parser, argc, argv);
+        if (snapshot_key != 0 && _cli_snapshot_load(parser, result, snapshot_key)) {
+            result->argc = argc;
+            result->argv = argv;
+            result->files = NULL;
+            result->file_count = 0;
+            return cli_ok;
+        }
+    }
+
+    if (!_cli_expand_response_files(result, argc, argv)) {
+        return result->error.status;
+    }
+    argc = result->argc;
+    argv = result->argv;
+
+    int cmd_depth;
+    int cmd_idx = _run_command(parser, argc, argv, &cmd_depth);
+    result->command = cmd_idx > 1 ? parser->commands[cmd_idx - 2].command : NULL;
+    result->cmd_idx = cmd_idx;
+    if (_cli_find_help(argc, argv)) {
+        result->error.status = cli_help_requested;
+        return cli_help_requested;
+    }
+
+    size_t pos_cursor = 0;
+    for (int argc_idx = 1 + cmd_depth; argc_idx < argc; argc_idx++) {
         char *arg = argv[argc_idx];
 
         bool matched_arg = false;
@@ -1084,32 +3661,51 @@ char *cli_parse_opts(cli_command *commands, cli_option *options, int argc, char
         }
 
         if (cli_streq(arg, "--") || cli_streq(arg, "-")) {
-            _cli_parse_remaining_positionals(options, commands, command, argc_idx, argc, argv);
-            _cli_check_mutual_exclusions(bin, cmd_idx, options, mutual_exclusions);
-            _cli_check_unmatched(bin, cmd_idx, options, mutual_exclusions);
-            return cmd_idx == 1 ? NULL : commands[cmd_idx - 2].command;
+            if (!_cli_parse_remaining_positionals(parser, result, cmd_idx, argc_idx, argc, argv, &pos_cursor)) {
+                return result->error.status;
+            }
+            break;
         }
 
-        if (cli_strcontains(arg, '=')) {
-            _cli_parse_equals(bin, options, arg, cmd_idx);
+        char *eq = NULL;
+        if (is_long) {
+            eq = strchr(arg + 2, '=');
+        } else if (!is_positional && arg[2] == '=') {
+            eq = arg + 2;
+        }
+        if (eq != NULL) {
+            if (!_cli_parse_equals(parser, result, argc_idx, arg, (size_t)(eq - arg), cmd_idx)) {
+                return result->error.status;
+            }
             continue;
         }
 
-        for (size_t opt_search = 0; opt_search < opt_count; opt_search++) {
-            cli_option opt = options[opt_search];
-            if (!(CLI_ARG_GLOBAL(opt.params)) && !(CLI_ARG_CMD(opt.params) == cmd_idx)) {
-                continue;
+        if (is_positional) {
+            if (!_cli_parse_positional(parser, result, argc_idx, cmd_idx, arg, &pos_cursor)) {
+                return result->error.status;
             }
-            if (is_positional && CLI_ARG_POSITIONAL(opt.params)) {
+            matched_arg = true;
+        } else {
+            uint32_t opt_idx;
+            if (is_long) {
+                if (!_cli_find_long_arg(parser, result, argc_idx, arg + 2, strlen(arg + 2), cmd_idx, &opt_idx)) {
+                    return result->error.status;
+                }
+            } else if (short_opt == multiple) {
+                if (!_cli_parse_short_cluster(parser, result, argc_idx, arg, cmd_idx, &opt_idx)) {
+                    return result->error.status;
+                }
                 matched_arg = true;
-                options[opt_search].params = CLI_ARG_SET_MATCHED(opt.params);
-                options[opt_search].data->str_data = arg;
-            } else if ((is_long && _cli_long_opt_eq(arg, opt.long_arg)) || (short_opt == single && arg[1] == opt.short_arg)) {
+            } else {
+                opt_idx = _cli_index_find_short(index, arg[1], cmd_idx);
+            }
+            if (opt_idx != CLI_INDEX_END) {
+                cli_option opt = options[opt_idx];
                 matched_arg = true;
-                options[opt_search].params = CLI_ARG_SET_MATCHED(opt.params);
 
                 if (CLI_ARG_TYPE(opt.params) == boolean) {
-                    options[opt_search].data->bool_data = true;
+                    _cli_set_matched(parser, result, opt_idx);
+                    _cli_value(parser, result, opt_idx)->bool_data = true;
                 } else {
                     if (argc_idx + 1 >= argc || _cli_is_option(argv[argc_idx + 1])) {
                         if (CLI_ARG_TYPE(opt.params) == number && argc_idx + 1 < argc) {
@@ -1117,53 +3713,143 @@ char *cli_parse_opts(cli_command *commands, cli_option *options, int argc, char
                             int64_t arg_num_parse_maybe = 0;
 
                             if (cli_try_parse_int(arg_num_param_maybe, &arg_num_parse_maybe)) {
-                                options[opt_search].data->num_data = arg_num_parse_maybe;
+                                _cli_set_matched(parser, result, opt_idx);
+                                _cli_value(parser, result, opt_idx)->num_data = arg_num_parse_maybe;
                                 argc_idx++;
                             } else {
-                                cli_fatalf_help(bin, "Missing argument: Option `%s` requires an argument but none was given", opt.long_arg);
+                                _cli_fail(result, cli_err_missing_argument, argc_idx, "Missing argument: Option `%s` requires an argument but none was given", opt.long_arg);
+                                return result->error.status;
                             }
                         } else if (CLI_ARG_TYPE(opt.params) == unumber && argc_idx + 1 < argc) {
-                            cli_fatalf_help(bin, "Invalid unsigned numerical value for option `%s`: %s", opt.long_arg, argv[argc_idx + 1]);
-                        } else {
-                            cli_fatalf_help(bin, "Missing argument: Option `%s` requires an argument but none was given", opt.long_arg);
-                        }
-                    } else if (CLI_ARG_TYPE(opt.params) == string) {
-                        options[opt_search].data->str_data = argv[++argc_idx];
-                    } else if (CLI_ARG_TYPE(opt.params) == number) {
-                        char *arg_num_param = argv[(++argc_idx)];
-                        int64_t arg_num_parse_res = 0;
-
-                        if (cli_try_parse_int(arg_num_param, &arg_num_parse_res)) {
-                            options[opt_search].data->num_data = arg_num_parse_res;
-                        } else {
-                            cli_fatalf(bin, "Invalid numerical sequence for option `%s`: %s", opt.long_arg, arg_num_param);
-                        }
-                    } else if (CLI_ARG_TYPE(opt.params) == unumber) {
-                        char *arg_unum_param = argv[(++argc_idx)];
-                        uint64_t arg_unum_parse_res = 0;
-
-                        if (cli_try_parse_uint(arg_unum_param, &arg_unum_parse_res)) {
-                            options[opt_search].data->num_data = arg_unum_parse_res;
+                            _cli_fail(result, cli_err_invalid_number, argc_idx + 1, "Invalid unsigned numerical value for option `%s`: %s", opt.long_arg, argv[argc_idx + 1]);
+                            return result->error.status;
                         } else {
-                            cli_fatalf(bin, "Invalid numerical sequence for option `%s`: %s", opt.long_arg, arg_unum_param);
+                            _cli_fail(result, cli_err_missing_argument, argc_idx, "Missing argument: Option `%s` requires an argument but none was given", opt.long_arg);
+                            return result->error.status;
                         }
+                    } else if (!_cli_parse_value(parser, result, argc_idx + 1, opt_idx, argv[argc_idx + 1])) {
+                        return result->error.status;
                     } else {
-                        cli_panic("Unrecognized type of flag encountered!");
+                        argc_idx++;
                     }
                 }
-            } else if (!is_long && short_opt == multiple) {
-                cli_fatal(bin, "Multiple shorthand options at once are not yet supported");
             }
         }
 
         if (!matched_arg) {
-            cli_fatalf_help(bin, "Unknown argument `%s`", arg);
+            _cli_fail(result, cli_err_unknown_argument, argc_idx, "Unknown argument `%s`", arg);
+            return result->error.status;
+        }
+    }
+
+    cli_layer env = {cli_source_env, NULL, 0, 0};
+    cli_layer file = {cli_source_file, NULL, 0, 0};
+    uint8_t *sources = result->sources;
+    bool ok = _cli_parse_env(parser, result, cmd_idx, &env) && _cli_parse_config(parser, result, cmd_idx, &file);
+    if (ok && (sources != NULL || parser->layer_count > 0 || env.len > 0 || file.len > 0)) {
+        if (sources == NULL) {
+            sources = (uint8_t *)_cli_alloc(result, parser->opt_count + 1);
         }
+        _cli_merge_layers(parser, result, cmd_idx, &file, &env, sources);
+    }
+    ok = ok && _cli_check_mutual_exclusions(parser, result, cmd_idx) && _cli_check_unmatched(parser, result, cmd_idx);
+    if (ok && snapshot_key != 0) {
+        _cli_snapshot_save(parser, result, snapshot_key, sources);
+    }
+    if (sources != NULL && sources != result->sources) {
+        _cli_release(result, sources);
+    }
+    if (env.entries != NULL) {
+        _cli_release(result, env.entries);
+    }
+    if (file.entries != NULL) {
+        _cli_release(result, file.entries);
+    }
+    return ok ? cli_ok : result->error.status;
+}
+
+/**
+ * @brief Parses the values in argv with a compiled parser. Prints the help menu and exits if it is requested. Prints the error and exits if parsing fails. If successful all the @ref opt_data_t in the options (or the values of the result) contain the respective values.
+ * @param parser The parser created with @ref cli_parser_compile
+ * @param argc The argc value
+ * @param argv The argv array
+ * @param result Optional result receiving the invoked command. If its values and matched arrays are set the options are not modified
+ * @return The name of the command invoked or NULL if the root command was invoked
+ * @note See @ref cli_parser_try_parse for a variant that never exits
+ * @note If no result is given response files stay in memory until the process exits
+ */
+char *cli_parser_parse(const cli_parser *parser, int argc, char *argv[], cli_result *result) {
+    cli_result local_result;
+    if (result == NULL) {
+        memset(&local_result, 0, sizeof(local_result));
+        result = &local_result;
     }
 
-    _cli_check_mutual_exclusions(bin, cmd_idx, options, mutual_exclusions);
-    _cli_check_unmatched(bin, cmd_idx, options, mutual_exclusions);
-    return cmd_idx == 1 ? NULL : commands[cmd_idx - 2].command;
+    switch (cli_parser_try_parse(parser, argc, argv, result)) {
+    case cli_ok:
+        return result->command;
+    case cli_help_requested:
+        _cli_help(parser, result->command, argv);
+        exit(0);
+    case cli_err_invalid_number:
+    case cli_err_response_file:
+    case cli_err_config_file:
+        cli_fatal(argv[0], result->error.message);
+    default:
+        cli_fatalf_help(argv[0], "%s", result->error.message);
+    }
+}
+
+/**
+ * @brief Parses the values in argv into the options defined in options. Fails automatically if an error during parsing is encountered. If successful all the @ref opt_data_t in the options contain the respective values.
+ * @param commands All commands of the cli. Set to NULL if there are no commands else a zero-terminated array of @ref command_t
+ * @param options All options of the cli as a zero-terminated array of @ref option_t
+ * @param argc The argc value
+ * @param argv The argv array
+ * @param exclusions Optional zero-terminated array of @ref exclusion_t to respect
+ * @param examples Optional zero-terminated array of examples
+ * @return The name of the command invoked or NULL if the root command was invoked
+ * @note Use @ref cli_parser_compile and @ref cli_parser_parse to parse more than one command line with the same tables. Tables of more than @ref CLI_ONESHOT_INDEX_OPTIONS options allocate their index on every call
+ */
+char *cli_parse_opts(cli_command *commands, cli_option *options, int argc, char *argv[], cli_exclusion mutual_exclusions[], cli_example examples[]) {
+    if (argc == 0 || argv == NULL) {
+        cli_panic("argc and argv are required");
+    }
+
+    cli_parser parser;
+    uint32_t storage[CLI_INDEX_STORAGE(CLI_ONESHOT_INDEX_OPTIONS)];
+    _cli_parser_setup(&parser, commands, options, mutual_exclusions, examples, storage, CLI_INDEX_STORAGE(CLI_ONESHOT_INDEX_OPTIONS));
+    char *command = cli_parser_parse(&parser, argc, argv, NULL);
+    if (parser.index.buckets != storage) {
+        cli_index_free(&parser.index);
+    }
+    return command;
+}
+
+/**
+ * @brief Parses the values in argv into the options defined in options without ever exiting the process. If successful all the @ref opt_data_t in the options contain the respective values.
+ * @param commands All commands of the cli. Set to NULL if there are no commands else a zero-terminated array of @ref command_t
+ * @param options All options of the cli as a zero-terminated array of @ref option_t
+ * @param argc The argc value
+ * @param argv The argv array
+ * @param exclusions Optional zero-terminated array of @ref exclusion_t to respect
+ * @param result The result receiving the invoked command and the error
+ * @return See @ref cli_parser_try_parse
+ * @note Tables of more than @ref CLI_ONESHOT_INDEX_OPTIONS options allocate their index on every call
+ */
+cli_status cli_try_parse_opts(cli_command *commands, cli_option *options, int argc, char *argv[], cli_exclusion mutual_exclusions[], cli_result *result) {
+    cli_parser parser;
+    uint32_t storage[CLI_INDEX_STORAGE(CLI_ONESHOT_INDEX_OPTIONS)];
+    _cli_parser_setup(&parser, commands, options, mutual_exclusions, NULL, storage, CLI_INDEX_STORAGE(CLI_ONESHOT_INDEX_OPTIONS));
+    cli_status status = cli_parser_try_parse(&parser, argc, argv, result);
+    if (parser.index.buckets != storage) {
+        cli_index_free(&parser.index);
+    }
+    return status;
+}
+#endif
+
+#ifdef __cplusplus
 }
 #endif
 #endif
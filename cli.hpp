@@ -0,0 +1,569 @@
+// https://github.com/auribuo/ccli
+//
+// Copyright (c) 2024 Aurelio Buonomo
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * @file cli.hpp
+ * @brief C++17 front-end of cli.h. Options are declared as constexpr descriptors bound to the fields of a result struct, validated at compile time and compiled into a ready-to-use parser.
+ * @author Aurelio Buonomo
+ * @version 1.0.0
+ */
+#ifndef CCLI_HPP
+#define CCLI_HPP
+
+#include "cli.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+
+namespace cli {
+
+/**
+ * @brief A command of the cli.
+ */
+struct command {
+    const char *name; /**< The name of the command. Required */
+    const char *desc; /**< Optional description to print in the help menu */
+};
+
+/**
+ * @brief Two options which must not be given together. Both names have to refer to an option of the spec.
+ */
+struct exclusion {
+    const char *one;   /**< Name of the first option */
+    const char *other; /**< Name of the second option */
+};
+
+/**
+ * @brief An example to print in the help menu.
+ */
+struct example {
+    const char *options;     /**< Only the options the cli has to be run with */
+    const char *description; /**< The description of the action performed */
+};
+
+namespace detail {
+
+/**
+ * @brief Reports an invalid spec. Not constexpr, so reaching it while a spec is constant-evaluated fails the compilation at the offending check.
+ * @param msg The reason the spec is invalid
+ */
+[[noreturn]] inline void invalid_spec(const char *msg) {
+    fprintf(stderr, "cli_panic: %s\n", msg);
+    exit(1);
+}
+
+/**
+ * @brief Compares two strings in a constant expression.
+ */
+constexpr bool streq(const char *a, const char *b) {
+    while (*a != 0 && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+/**
+ * @brief Hashes the given string in a constant expression. Matches the hash the C index uses.
+ */
+constexpr uint32_t hash(const char *s) {
+    uint32_t hash = 2166136261u;
+    for (; *s != 0; s++) {
+        hash = (hash ^ (unsigned char)*s) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Whether two options with the given command fields are visible in the same command.
+ */
+constexpr bool scopes_overlap(uint32_t a, uint32_t b) {
+    return a == 0 || b == 0 || a == b;
+}
+
+template <typename>
+struct member_traits;
+
+template <typename C, typename T>
+struct member_traits<T C::*> {
+    using owner = C;
+    using type = T;
+};
+
+template <typename>
+constexpr bool unsupported_type = false;
+
+/**
+ * @brief Maps the type of a field of the result struct to the type of its option.
+ */
+template <typename T>
+constexpr cli_option_type option_type() {
+    if constexpr (std::is_same_v<T, bool>) {
+        return ::boolean;
+    } else if constexpr (std::is_same_v<T, const char *>) {
+        return ::string;
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == sizeof(int64_t)) {
+        return ::number;
+    } else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) == sizeof(uint64_t)) {
+        return ::unumber;
+    } else if constexpr (std::is_same_v<T, cli_list>) {
+        return ::list;
+    } else {
+        static_assert(unsupported_type<T>, "Fields bound to an option must be bool, const char *, int64_t, uint64_t or cli_list");
+        return ::boolean;
+    }
+}
+
+/**
+ * @brief Stores a parsed value in the field Member. The union member read is fixed at compile time.
+ */
+template <auto Member>
+void assign(typename member_traits<decltype(Member)>::owner &args, const cli_data &data) {
+    using T = typename member_traits<decltype(Member)>::type;
+    constexpr cli_option_type type = option_type<T>();
+    if constexpr (type == ::boolean) {
+        args.*Member = data.bool_data;
+    } else if constexpr (type == ::string) {
+        args.*Member = data.str_data;
+    } else if constexpr (type == ::number) {
+        args.*Member = data.num_data;
+    } else if constexpr (type == ::unumber) {
+        args.*Member = data.unum_data;
+    } else {
+        args.*Member = data.list_data;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Describes an option bound to a field of the result struct Args. Create it with @ref opt.
+ */
+template <typename Args>
+struct option {
+    char short_arg;                            /**< The shorthand version of the option or 0 */
+    const char *long_arg;                      /**< The long version and name of the option. Required */
+    cli_option_type type;                      /**< The type of the option. Follows from the type of the field */
+    uint32_t cmd;                              /**< The command as encoded in @ref CLI_ARG_MAKE. 0 for global options */
+    bool is_required;                          /**< Whether the option is required */
+    bool is_positional;                        /**< Whether the option is positional */
+    const char *desc;                          /**< Optional description to print in the help menu */
+    const char *arg_desc;                      /**< Name of the parameter. Required unless the option is boolean or positional */
+    void (*assign)(Args &, const cli_data &);  /**< Stores a parsed value in the bound field */
+
+    /**
+     * @brief Returns a copy of the option which is required.
+     */
+    constexpr option required() const {
+        option opt = *this;
+        opt.is_required = true;
+        return opt;
+    }
+
+    /**
+     * @brief Returns a copy of the option which is positional.
+     */
+    constexpr option positional() const {
+        option opt = *this;
+        opt.is_positional = true;
+        return opt;
+    }
+
+    /**
+     * @brief Returns a copy of the option which is only available to the root command.
+     */
+    constexpr option root() const {
+        option opt = *this;
+        opt.cmd = 1;
+        return opt;
+    }
+
+    /**
+     * @brief Returns a copy of the option which is only available to the given command.
+     * @param idx The index of the command in the commands of the spec
+     */
+    constexpr option command(size_t idx) const {
+        option opt = *this;
+        opt.cmd = (uint32_t)(idx + 2);
+        return opt;
+    }
+
+    /**
+     * @brief Returns the params field of the option. See @ref CLI_ARG_MAKE.
+     */
+    constexpr uint64_t params() const {
+        return ((uint64_t)cmd << 32) | ((uint64_t)is_required << 15) | ((uint64_t)is_positional << 14) | (uint64_t)type;
+    }
+};
+
+/**
+ * @brief Creates a global option bound to the field Member. The type of the option follows from the type of the field.
+ * @param short_arg The shorthand version of the option or 0
+ * @param long_arg The long version and name of the option
+ * @param desc Optional description to print in the help menu
+ * @param arg_desc Name of the parameter. Required unless the option is boolean or positional
+ */
+template <auto Member>
+constexpr option<typename detail::member_traits<decltype(Member)>::owner> opt(char short_arg, const char *long_arg, const char *desc, const char *arg_desc = nullptr) {
+    using T = typename detail::member_traits<decltype(Member)>::type;
+    return {short_arg, long_arg, detail::option_type<T>(), 0, false, false, desc, arg_desc, &detail::assign<Member>};
+}
+
+/**
+ * @brief The validated tables of a cli. Create it with @ref make_spec as a constexpr variable so invalid tables fail to compile.
+ */
+template <typename Args, size_t OptCount, size_t CmdCount, size_t ExclCount, size_t ExampleCount>
+struct spec {
+    using args_type = Args;
+
+    std::array<option<Args>, OptCount> options;  /**< The options */
+    std::array<command, CmdCount> commands;      /**< The commands */
+    std::array<exclusion, ExclCount> exclusions; /**< Pairs of mutually exclusive options */
+    std::array<example, ExampleCount> examples;  /**< Examples to print in the help menu */
+
+    /**
+     * @brief Creates the spec and validates it. Fails to compile if an invalid spec is constant-evaluated, else panics.
+     */
+    constexpr spec(const std::array<option<Args>, OptCount> &options, const std::array<command, CmdCount> &commands, const std::array<exclusion, ExclCount> &exclusions, const std::array<example, ExampleCount> &examples)
+        : options(options), commands(commands), exclusions(exclusions), examples(examples) {
+        validate();
+    }
+
+    /**
+     * @brief Finds the option with the given long name.
+     * @return The index of the first option with the name or OptCount
+     */
+    constexpr size_t find(const char *name) const {
+        for (size_t i = 0; i < OptCount; i++) {
+            if (detail::streq(options[i].long_arg, name)) {
+                return i;
+            }
+        }
+        return OptCount;
+    }
+
+  private:
+    constexpr void validate() const {
+        static_assert(OptCount < CLI_INDEX_END / 7 && CmdCount < CLI_INDEX_END / 7, "Too many entries to index");
+        for (size_t i = 0; i < CmdCount; i++) {
+            if (commands[i].name == nullptr || commands[i].name[0] == 0) {
+                detail::invalid_spec("Invalid command. The name of a command is always required!");
+            }
+            for (size_t j = 0; j < i; j++) {
+                if (detail::streq(commands[i].name, commands[j].name)) {
+                    detail::invalid_spec("Invalid command. Command names have to be unique!");
+                }
+            }
+        }
+        for (size_t i = 0; i < OptCount; i++) {
+            const option<Args> &opt = options[i];
+            if (opt.long_arg == nullptr || opt.long_arg[0] == 0) {
+                detail::invalid_spec("Invalid option. Long option is always required!");
+            }
+            if (opt.type != ::boolean && !opt.is_positional && opt.arg_desc == nullptr) {
+                detail::invalid_spec("Invalid option. If option is not boolean arg_desc is required!");
+            }
+            if (opt.cmd >= CmdCount + 2) {
+                detail::invalid_spec("Invalid option. The command of the option does not exist!");
+            }
+            for (size_t j = 0; j < i; j++) {
+                if (!detail::scopes_overlap(opt.cmd, options[j].cmd)) {
+                    continue;
+                }
+                if (detail::streq(opt.long_arg, options[j].long_arg)) {
+                    detail::invalid_spec("Invalid option. Duplicate long option in the same command!");
+                }
+                if (opt.short_arg != 0 && opt.short_arg == options[j].short_arg) {
+                    detail::invalid_spec("Invalid option. Duplicate short option in the same command!");
+                }
+            }
+        }
+        for (size_t i = 0; i < ExclCount; i++) {
+            if (exclusions[i].one == nullptr || exclusions[i].other == nullptr) {
+                detail::invalid_spec("Invalid exclusion. Both options are required!");
+            }
+            if (find(exclusions[i].one) == OptCount || find(exclusions[i].other) == OptCount) {
+                detail::invalid_spec("Invalid exclusion. Both options have to exist!");
+            }
+        }
+    }
+};
+
+/**
+ * @brief Creates a validated spec. Declare the result as a constexpr variable at namespace scope to validate it at compile time and pass it to @ref parser.
+ * @param options The options
+ * @param commands The commands
+ * @param exclusions Pairs of mutually exclusive options
+ * @param examples Examples to print in the help menu
+ */
+template <typename Args, size_t OptCount, size_t CmdCount = 0, size_t ExclCount = 0, size_t ExampleCount = 0>
+constexpr spec<Args, OptCount, CmdCount, ExclCount, ExampleCount> make_spec(const std::array<option<Args>, OptCount> &options, const std::array<command, CmdCount> &commands = {}, const std::array<exclusion, ExclCount> &exclusions = {}, const std::array<example, ExampleCount> &examples = {}) {
+    return {options, commands, exclusions, examples};
+}
+
+namespace detail {
+
+/**
+ * @brief The C tables and the lookup index of a spec. Every array carries the terminating zero entry the C tables expect.
+ */
+template <size_t OptCount, size_t CmdCount, size_t ExclCount, size_t ExampleCount>
+struct tables {
+    /**
+     * @brief Returns the amount of buckets of an index over count names. Matches _cli_index_bucket_count.
+     */
+    static constexpr size_t bucket_count(size_t count) {
+        size_t bucket_count = 16;
+        while (bucket_count < count * 2) {
+            bucket_count <<= 1;
+        }
+        return bucket_count;
+    }
+
+    std::array<cli_option, OptCount + 1> options;
+    std::array<cli_command, CmdCount + 1> commands;
+    std::array<cli_exclusion, ExclCount + 1> exclusions;
+    std::array<cli_example, ExampleCount + 1> examples;
+    std::array<uint32_t, bucket_count(OptCount) + OptCount * 7> block;
+    std::array<uint32_t, bucket_count(CmdCount) + CmdCount * 2> cmd_block;
+    std::array<uint32_t, 256> short_head;
+    size_t pos_count;
+    size_t req_count;
+    size_t cmd_max_depth;
+};
+
+/**
+ * @brief Converts a spec into C tables and builds the lookup index the same way _cli_index_build_into does.
+ */
+template <typename Args, size_t OptCount, size_t CmdCount, size_t ExclCount, size_t ExampleCount>
+constexpr tables<OptCount, CmdCount, ExclCount, ExampleCount> make_tables(const spec<Args, OptCount, CmdCount, ExclCount, ExampleCount> &s) {
+    using tables_type = tables<OptCount, CmdCount, ExclCount, ExampleCount>;
+    tables_type t{};
+    for (size_t i = 0; i < OptCount; i++) {
+        const option<Args> &opt = s.options[i];
+        t.options[i].short_arg = opt.short_arg;
+        t.options[i].long_arg = const_cast<char *>(opt.long_arg);
+        t.options[i].params = opt.params();
+        t.options[i].desc = const_cast<char *>(opt.desc);
+        t.options[i].arg_desc = const_cast<char *>(opt.arg_desc);
+    }
+    for (size_t i = 0; i < CmdCount; i++) {
+        t.commands[i].command = const_cast<char *>(s.commands[i].name);
+        t.commands[i].desc = const_cast<char *>(s.commands[i].desc);
+    }
+    for (size_t i = 0; i < ExclCount; i++) {
+        t.exclusions[i].one = const_cast<char *>(s.exclusions[i].one);
+        t.exclusions[i].other = const_cast<char *>(s.exclusions[i].other);
+    }
+    for (size_t i = 0; i < ExampleCount; i++) {
+        t.examples[i].options = const_cast<char *>(s.examples[i].options);
+        t.examples[i].description = const_cast<char *>(s.examples[i].description);
+    }
+
+    constexpr size_t bucket_count = tables_type::bucket_count(OptCount);
+    uint32_t *buckets = t.block.data();
+    uint32_t *hashes = buckets + bucket_count;
+    uint32_t *long_next = hashes + OptCount;
+    uint32_t *short_next = long_next + OptCount;
+    uint32_t *positionals = short_next + OptCount;
+    uint32_t *required = positionals + OptCount;
+    uint32_t *cmds = required + OptCount;
+    for (size_t i = 0; i < bucket_count; i++) {
+        buckets[i] = CLI_INDEX_END;
+    }
+    for (size_t i = 0; i < 256; i++) {
+        t.short_head[i] = CLI_INDEX_END;
+    }
+    for (size_t i = OptCount; i-- > 0;) {
+        const option<Args> &opt = s.options[i];
+        hashes[i] = hash(opt.long_arg);
+        long_next[i] = buckets[hashes[i] & (bucket_count - 1)];
+        buckets[hashes[i] & (bucket_count - 1)] = (uint32_t)i;
+        short_next[i] = CLI_INDEX_END;
+        cmds[i] = opt.cmd;
+        if (opt.short_arg != 0) {
+            short_next[i] = t.short_head[(unsigned char)opt.short_arg];
+            t.short_head[(unsigned char)opt.short_arg] = (uint32_t)i;
+        }
+    }
+    for (size_t i = 0; i < OptCount; i++) {
+        if (s.options[i].is_positional) {
+            positionals[t.pos_count++] = (uint32_t)i;
+        }
+        if (s.options[i].is_required) {
+            required[t.req_count++] = (uint32_t)i;
+        }
+    }
+
+    constexpr size_t cmd_bucket_count = tables_type::bucket_count(CmdCount);
+    uint32_t *cmd_buckets = t.cmd_block.data();
+    uint32_t *cmd_hashes = cmd_buckets + cmd_bucket_count;
+    uint32_t *cmd_next = cmd_hashes + CmdCount;
+    for (size_t i = 0; i < cmd_bucket_count; i++) {
+        cmd_buckets[i] = CLI_INDEX_END;
+    }
+    for (size_t i = CmdCount; i-- > 0;) {
+        size_t depth = 1;
+        for (const char *c = s.commands[i].name; *c != 0; c++) {
+            depth += *c == ' ';
+        }
+        if (depth > t.cmd_max_depth) {
+            t.cmd_max_depth = depth;
+        }
+        cmd_hashes[i] = hash(s.commands[i].name);
+        cmd_next[i] = cmd_buckets[cmd_hashes[i] & (cmd_bucket_count - 1)];
+        cmd_buckets[cmd_hashes[i] & (cmd_bucket_count - 1)] = (uint32_t)i;
+    }
+    return t;
+}
+
+} // namespace detail
+
+#ifdef CCLI_IMPLEMENTATION
+
+/**
+ * @brief Parser for the spec Spec. The C tables, the lookup index and the parser itself are constant-initialized, so constructing it does no work.
+ * @tparam Spec A constexpr spec created with @ref make_spec
+ */
+template <const auto &Spec>
+class parser {
+    using spec_type = std::remove_cv_t<std::remove_reference_t<decltype(Spec)>>;
+    using args_type = typename spec_type::args_type;
+    static constexpr size_t opt_count = std::tuple_size_v<decltype(spec_type::options)>;
+    static constexpr size_t cmd_count = std::tuple_size_v<decltype(spec_type::commands)>;
+    static constexpr size_t excl_count = std::tuple_size_v<decltype(spec_type::exclusions)>;
+    static constexpr size_t example_count = std::tuple_size_v<decltype(spec_type::examples)>;
+
+    static constexpr auto tables = detail::make_tables(Spec);
+
+    static constexpr cli_parser make_parser() {
+        using tables_type = std::remove_cv_t<decltype(tables)>;
+        cli_parser p{};
+        p.commands = cmd_count > 0 ? const_cast<cli_command *>(tables.commands.data()) : nullptr;
+        p.options = const_cast<cli_option *>(tables.options.data());
+        p.exclusions = excl_count > 0 ? const_cast<cli_exclusion *>(tables.exclusions.data()) : nullptr;
+        p.examples = example_count > 0 ? const_cast<cli_example *>(tables.examples.data()) : nullptr;
+        p.cmd_count = cmd_count;
+        p.opt_count = opt_count;
+        p.index.opt_count = opt_count;
+        p.index.mask = (uint32_t)(tables_type::bucket_count(opt_count) - 1);
+        p.index.buckets = const_cast<uint32_t *>(tables.block.data());
+        p.index.hashes = p.index.buckets + tables_type::bucket_count(opt_count);
+        p.index.long_next = p.index.hashes + opt_count;
+        p.index.short_next = p.index.long_next + opt_count;
+        p.index.positionals = p.index.short_next + opt_count;
+        p.index.pos_count = tables.pos_count;
+        p.index.required = p.index.positionals + opt_count;
+        p.index.req_count = tables.req_count;
+        p.index.cmds = p.index.required + opt_count;
+        p.index.sorted = nullptr;
+        for (size_t i = 0; i < 256; i++) {
+            p.index.short_head[i] = tables.short_head[i];
+        }
+        p.cmd_index.mask = (uint32_t)(tables_type::bucket_count(cmd_count) - 1);
+        p.cmd_index.buckets = const_cast<uint32_t *>(tables.cmd_block.data());
+        p.cmd_index.hashes = p.cmd_index.buckets + tables_type::bucket_count(cmd_count);
+        p.cmd_index.next = p.cmd_index.hashes + cmd_count;
+        p.cmd_index.max_depth = tables.cmd_max_depth;
+        p.help = nullptr;
+        return p;
+    }
+
+    static constexpr cli_parser compiled = make_parser();
+
+    template <size_t... I>
+    static void assign(args_type &args, const cli_data *values, const bool *matched, std::index_sequence<I...>) {
+        ((matched[I] ? Spec.options[I].assign(args, values[I]) : void()), ...);
+    }
+
+  public:
+    /**
+     * @brief Returns the underlying C parser, e.g. to render the help menu with @ref cli_parser_help_render. The parser is read-only.
+     */
+    static const cli_parser *c_parser() {
+        return &compiled;
+    }
+
+    /**
+     * @brief Parses the given arguments into args. Fields of options that are not given are left untouched, so default member initializers act as defaults.
+     * @param argc The argc value
+     * @param argv The argv array
+     * @param args Receives the values of all given options
+     * @param result Receives the outcome. Release it with @ref cli_result_free once the strings in args are no longer needed. Its values and matched arrays are managed by the parser
+     * @return The outcome of the parse. Nothing is assigned unless it is @ref cli_ok
+     */
+    static cli_status try_parse(int argc, char *argv[], args_type &args, cli_result &result) {
+        std::array<cli_data, opt_count + 1> values{};
+        std::array<bool, opt_count + 1> matched{};
+        result.values = values.data();
+        result.matched = matched.data();
+        cli_status status = cli_parser_try_parse(&compiled, argc, argv, &result);
+        result.values = nullptr;
+        result.matched = nullptr;
+        if (status == cli_ok) {
+            assign(args, values.data(), matched.data(), std::make_index_sequence<opt_count>());
+        }
+        return status;
+    }
+
+    /**
+     * @brief Parses the given arguments into a new result struct. Prints the help menu and exits if it is requested. Prints the error and exits if parsing fails.
+     * @param argc The argc value
+     * @param argv The argv array
+     * @param command Optional pointer receiving the name of the invoked command or NULL if the root command was invoked
+     * @return The result struct, starting from its default member initializers
+     * @note Response files stay in memory until the process exits
+     */
+    static args_type parse(int argc, char *argv[], char **command = nullptr) {
+        args_type args{};
+        std::array<cli_data, opt_count + 1> values{};
+        std::array<bool, opt_count + 1> matched{};
+        cli_result result{};
+        result.values = values.data();
+        result.matched = matched.data();
+        char *invoked = cli_parser_parse(&compiled, argc, argv, &result);
+        assign(args, values.data(), matched.data(), std::make_index_sequence<opt_count>());
+        if (command != nullptr) {
+            *command = invoked;
+        }
+        return args;
+    }
+
+    /**
+     * @brief Prints the help menu of the given command.
+     * @param command The name of the command or NULL for the root command
+     * @param argv The argv array
+     */
+    static void help(char *command, char *argv[]) {
+        cli_parser_help(&compiled, command, argv);
+    }
+};
+
+#endif
+
+} // namespace cli
+
+#endif